@@ -0,0 +1,149 @@
+/**
+ * @file affinity_bench.cpp
+ * @brief Producer tail latency with an unpinned worker vs. a worker pinned away from the producers.
+ *
+ * Each scenario runs in a forked child (placement is fixed at init):
+ *   unpinned  producers pinned to CPUs 0..P-1, worker free to migrate (the default)
+ *   pinned    same producers, worker pinned to the last CPU (Config::workerCpus) at
+ *             ThreadPolicy::Batch, so it never shares a core with a producer
+ *
+ * Usage: kl_bench_affinity [messages-per-producer] [log-dir]
+ * stdout is redirected to /dev/null; entries go to the file sink (tmpfs by default).
+ * Needs at least 2 CPUs to say anything useful.
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    bool pinWorker;
+};
+
+constexpr Scenario kScenarios[] = {
+    {"unpinned", false},
+    {"pinned",   true},
+};
+
+int run_scenario(const Scenario& scenario, size_t messages, const std::string& directory)
+{
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    const int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int workerCpu = cpus - 1;
+    const int producers = std::max(1, std::min(4, cpus - 1));
+
+    KL::Config config;
+    config.folderPath = directory;
+    config.crashHandler = false;
+    if (scenario.pinWorker) {
+        config.workerCpus = {workerCpu};
+        config.workerPolicy = KL::ThreadPolicy::Batch;
+    }
+    KL::Logger& logger = KL::Logger::get_instance();
+    logger.init(config);
+
+    const std::string payload(64, 'x');
+    std::vector<std::vector<uint64_t>> samples(static_cast<size_t>(producers));
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            KL::ThreadPlacement::pin({p % cpus});
+            auto& latencies = samples[static_cast<size_t>(p)];
+            latencies.resize(messages);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < messages; ++i) {
+                const auto start = std::chrono::steady_clock::now();
+                FLOG_INFO(payload);
+                latencies[i] = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+                if ((i & 63) == 63) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(20));    // Sustained, not saturating
+                }
+            }
+        });
+    }
+    while (ready.load() != producers) {
+        std::this_thread::yield();
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    std::vector<uint64_t> all;
+    for (const auto& latencies : samples) {
+        all.insert(all.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    const auto at = [&all](double q) {
+        return static_cast<unsigned long long>(all[std::min(all.size() - 1, static_cast<size_t>(q * static_cast<double>(all.size())))]);
+    };
+
+    std::fprintf(stderr, "%-9s %5d %6s %9zu %8llu %8llu %8llu %10llu\n",
+                 scenario.name, producers, scenario.pinWorker ? std::to_string(workerCpu).c_str() : "-",
+                 all.size(), at(0.50), at(0.99), at(0.999), static_cast<unsigned long long>(all.back()));
+    std::fflush(stderr);
+
+    logger.flush_and_shutdown();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t messages = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const std::string directory = (argc > 2) ? argv[2] : "/dev/shm/kl_bench_affinity";
+
+    if (std::thread::hardware_concurrency() < 2) {
+        std::fprintf(stderr, "note: fewer than 2 CPUs; worker and producers necessarily share a core\n");
+    }
+    std::fprintf(stderr, "%-9s %5s %6s %9s %8s %8s %8s %10s\n",
+                 "worker", "prods", "w_cpu", "msgs", "p50_ns", "p99_ns", "p999_ns", "max_ns");
+    std::fflush(stderr);
+
+    int failures = 0;
+    for (const Scenario& scenario : kScenarios) {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+
+        const pid_t child = fork();
+        if (child == 0) {
+            std::_Exit(run_scenario(scenario, messages, directory));
+        }
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failures;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    return failures == 0 ? 0 : 1;
+}
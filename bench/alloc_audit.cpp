@@ -0,0 +1,372 @@
+/**
+ * @file alloc_audit.cpp
+ * @brief Allocation and syscall budgets for the logging hot path.
+ *
+ * Each mode runs in a forked child (the logger is a process-wide singleton, so every Config
+ * needs a fresh process). The child:
+ *   1. replaces global operator new/delete with counting versions, attributed per thread role
+ *      (producer = the thread calling log(), worker = every other thread),
+ *   2. installs a counting KL::IO::Backend, so write()/fdatasync()/open() calls of the sinks
+ *      are counted per sink,
+ *   3. warms up (first file, thread-name table, buffer growth), resets the counters, then logs
+ *      a burst in steady state and waits for Logger::flush().
+ *
+ * Modes cover both sinks, the default Config and the batch scheduler, every fsync policy,
+ * the LOGF_ / deferred macro families and a rate-limited call site. Per-message costs are
+ * compared against the budgets in kModes; any violation makes the program exit with
+ * status 1, so it can gate CI (ctest runs it as kl_audit) or a bisect.
+ *
+ * Usage: kl_audit [messages-per-mode] [log-dir]
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct AllocCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+AllocCounters gProducerAllocs;
+AllocCounters gWorkerAllocs;
+thread_local AllocCounters* tAllocCounters = &gWorkerAllocs;
+
+struct IoCounters {
+    std::atomic<uint64_t> consoleWrites{0};
+    std::atomic<uint64_t> fileWrites{0};
+    std::atomic<uint64_t> syncs{0};
+    std::atomic<uint64_t> opens{0};
+};
+
+IoCounters gIo;
+KL::IO::Backend gSystem = KL::IO::system_backend();
+
+int counting_open(const char* path) noexcept
+{
+    gIo.opens.fetch_add(1, std::memory_order_relaxed);
+    return gSystem.open_append(path);
+}
+
+std::ptrdiff_t counting_write(int fd, const char* data, size_t size) noexcept
+{
+    (fd <= 2 ? gIo.consoleWrites : gIo.fileWrites).fetch_add(1, std::memory_order_relaxed);
+    return gSystem.write(fd, data, size);
+}
+
+bool counting_sync(int fd) noexcept
+{
+    gIo.syncs.fetch_add(1, std::memory_order_relaxed);
+    return gSystem.sync_data(fd);
+}
+
+/// Which macro family a mode logs through
+enum class Call {
+    Plain,              // LOG_INFO / FLOG_INFO with a std::string
+    Format,             // LOGF_INFO / FLOGF_INFO, formatted on the producer
+    FormatDeferred,     // LOGF_INFO_DEFERRED / FLOGF_INFO_DEFERRED, arguments encoded for the worker
+    Deferred,           // LOG_INFO_DEFERRED / FLOG_INFO_DEFERRED with a callable run on the worker
+};
+
+/// Per logged message, measured in steady state over one burst plus one flush()
+struct Budget {
+    double producerAllocs;          // The std::string argument itself, when it exceeds SSO
+    double workerAllocs;
+    double consoleWrites;
+    double fileWrites;
+    double syncs;                   // On top of the one done by flush() (and, for Interval, one per interval)
+};
+
+struct Mode {
+    const char* name;
+    bool toFile;
+    Call call;
+    size_t messageBytes;            // Payload of Plain / Deferred; Format modes log one integer (plus the payload if > 8 B)
+    bool sanitize;
+    bool decorate;                  // showThread + showSourceLocation
+    bool batched;                   // batchMaxDelay / batchMinEntries set; otherwise the default Config
+    KL::FsyncPolicy fsync;
+    bool rateLimited;               // kRateLimit on INFO: nearly every message is rejected
+    KL::Level level;
+    Budget budget;
+};
+
+// Batched sinks measure 0.0007-0.0054 writes per message; one write() per line would be 1.0
+constexpr double kWritesPerMsg = 0.02;
+
+// Without batching a drain pass may hold a single entry, but never costs more than one write()
+constexpr double kUnbatchedWritesPerMsg = 1.0;
+
+// ERROR lines go to stderr unbuffered, one write() each
+constexpr double kStderrWritesPerMsg = 1.0;
+
+// At most one sync per batch of at least kBatchMinEntries
+constexpr size_t kBatchMinEntries = 256;
+constexpr double kSyncsPerBatchedMsg = 1.0 / kBatchMinEntries;
+
+// 256 B lines are ~290 B on disk: one sync per ~225 lines, rounded up to whole batches
+constexpr size_t kFsyncBytes = 64 * 1024;
+constexpr double kSyncsPerBytesMsg = 0.006;
+
+// format() reserves room for short arguments: a 256 B one grows the result once more
+constexpr double kFormatLongArgAllocs = 2.0;
+
+// The encoded format pointer, length and one integer (24 B) exceed std::string's inline buffer
+constexpr double kEncodedArgsAllocs = 1.0;
+
+// 1000/s with a burst of 10: a burst of messages is almost all rejected before it is built
+constexpr KL::RateLimit kRateLimit{1000, 10};
+constexpr double kRateLimitedPerMsg = 0.01;
+
+using KL::FsyncPolicy;
+using KL::Level;
+
+constexpr Mode kModes[] = {
+    {"console, 8 B",           false, Call::Plain, 8,   false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {0.0, 0.0, kWritesPerMsg, 0.0, 0.0}},
+    {"console, 256 B",         false, Call::Plain, 256, false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, 0.0, 0.0}},
+    {"file, 8 B",              true,  Call::Plain, 8,   false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {0.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"file, 256 B",            true,  Call::Plain, 256, false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"file, 256 B, sanitize",  true,  Call::Plain, 256, true,  false, true,  FsyncPolicy::None, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"file, 256 B, decorated", true,  Call::Plain, 256, false, true,  true,  FsyncPolicy::None, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"file, 256 B, default",   true,  Call::Plain, 256, false, false, false, FsyncPolicy::None, false, Level::INFO,
+        {1.0, 0.0, kUnbatchedWritesPerMsg, kUnbatchedWritesPerMsg, 0.0}},
+    {"fsync interval",         true,  Call::Plain, 256, false, false, true,  FsyncPolicy::Interval, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"fsync bytes",            true,  Call::Plain, 256, false, false, true,  FsyncPolicy::Bytes, false, Level::INFO,
+        {1.0, 0.0, kWritesPerMsg, kWritesPerMsg, kSyncsPerBytesMsg}},
+    {"fsync on error, ERROR",  true,  Call::Plain, 256, false, false, true,  FsyncPolicy::OnError, false, Level::ERROR,
+        {1.0, 0.0, kStderrWritesPerMsg, kWritesPerMsg, kSyncsPerBatchedMsg}},
+    {"format, int",            true,  Call::Format, 8,  false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {0.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"format, int + 256 B",    true,  Call::Format, 256, false, false, true, FsyncPolicy::None, false, Level::INFO,
+        {kFormatLongArgAllocs, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"format deferred, int",   true,  Call::FormatDeferred, 8, false, false, true, FsyncPolicy::None, false, Level::INFO,
+        {kEncodedArgsAllocs, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"deferred callable, int", true,  Call::Deferred, 8, false, false, true,  FsyncPolicy::None, false, Level::INFO,
+        {0.0, 0.0, kWritesPerMsg, kWritesPerMsg, 0.0}},
+    {"rate-limited, 256 B",    true,  Call::Plain, 256, false, false, true,  FsyncPolicy::None, true,  Level::INFO,
+        {kRateLimitedPerMsg, kRateLimitedPerMsg, kWritesPerMsg, kWritesPerMsg, 0.0}},
+};
+
+void log_burst(const Mode& mode, const std::string& payload, size_t count)
+{
+    const bool error = (mode.level == Level::ERROR);
+    for (size_t i = 0; i < count; ++i) {
+        switch (mode.call) {
+        case Call::Plain:
+            if (error) {
+                FLOG_ERROR(payload);
+            }
+            else if (mode.toFile) {
+                FLOG_INFO(payload);
+            }
+            else {
+                LOG_INFO(payload);
+            }
+            break;
+        case Call::Format:
+            if (payload.size() > 8) {
+                FLOGF_INFO("{} {}", i, payload);
+            }
+            else {
+                FLOGF_INFO("n={}", i);
+            }
+            break;
+        case Call::FormatDeferred:
+            FLOGF_INFO_DEFERRED("n={}", i);
+            break;
+        case Call::Deferred:
+            FLOG_INFO_DEFERRED([i] { return KL::format("n={}", i); });
+            break;
+        }
+    }
+}
+
+/// Child process body: returns 0 if every budget holds
+int run_mode(const Mode& mode, size_t messages, const std::string& directory)
+{
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+    // ERROR lines go to stderr as well: report on a copy of it and silence the original
+    FILE* report = stderr;
+    if (mode.level == Level::ERROR) {
+        const int devNull = open("/dev/null", O_WRONLY);
+        report = fdopen(dup(STDERR_FILENO), "w");
+        if (devNull < 0 || report == nullptr || dup2(devNull, STDERR_FILENO) < 0) {
+            return 2;
+        }
+        close(devNull);
+    }
+    tAllocCounters = &gProducerAllocs;
+
+    KL::IO::set_backend(KL::IO::Backend{&counting_open, &counting_write, &counting_sync, gSystem.close});
+
+    KL::Config config;
+    config.folderPath = directory;
+    config.maxLinesPerFile = messages * 4;     // No rotation inside the measured burst
+    config.sanitize = mode.sanitize;
+    config.showThread = mode.decorate;
+    config.showSourceLocation = mode.decorate;
+    config.crashHandler = false;
+    if (mode.batched) {
+        // Batches of at least kBatchMinEntries, so the write budgets do not depend on how closely
+        // a worker on another core keeps up with the producer
+        config.batchMaxDelay = std::chrono::milliseconds(2);
+        config.batchMinEntries = kBatchMinEntries;
+    }
+    config.fsyncPolicy = mode.fsync;
+    config.fsyncBytes = kFsyncBytes;
+    if (mode.rateLimited) {
+        config.rateLimits[static_cast<size_t>(Level::INFO)] = kRateLimit;
+    }
+    KL::Logger& logger = KL::Logger::get_instance();
+    logger.init(config);
+    if (mode.decorate) {
+        KL::set_thread_name("producer");
+    }
+
+    std::string payload(mode.messageBytes, 'a');
+    if (mode.sanitize) {
+        payload[mode.messageBytes / 2] = '\n';
+    }
+
+    log_burst(mode, payload, messages / 4);
+    logger.flush();
+
+    gProducerAllocs.allocations = 0;
+    gWorkerAllocs.allocations = 0;
+    gIo.consoleWrites = 0;
+    gIo.fileWrites = 0;
+    gIo.syncs = 0;
+    gIo.opens = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    log_burst(mode, payload, messages);
+    logger.flush();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    const double n = static_cast<double>(messages);
+    const double producerAllocs = static_cast<double>(gProducerAllocs.allocations.load()) / n;
+    const double workerAllocs = static_cast<double>(gWorkerAllocs.allocations.load()) / n;
+    const double consoleWrites = static_cast<double>(gIo.consoleWrites.load()) / n;
+    const double fileWrites = static_cast<double>(gIo.fileWrites.load()) / n;
+    const uint64_t syncs = gIo.syncs.load();
+
+    // The sync done by flush(), plus one per elapsed interval for FsyncPolicy::Interval
+    double allowedSyncs = mode.budget.syncs * n + (mode.toFile ? 1 : 0);
+    if (mode.fsync == FsyncPolicy::Interval) {
+        allowedSyncs += static_cast<double>(elapsed / config.fsyncInterval) + 1;
+    }
+
+    const bool ok = producerAllocs <= mode.budget.producerAllocs
+                 && workerAllocs <= mode.budget.workerAllocs
+                 && consoleWrites <= mode.budget.consoleWrites
+                 && fileWrites <= mode.budget.fileWrites
+                 && static_cast<double>(syncs) <= allowedSyncs
+                 && gIo.opens.load() == 0;
+
+    std::fprintf(report, "%-24s %9.4f %9.4f %9.4f %9.4f %6llu %6llu  %s\n", mode.name,
+                 producerAllocs, workerAllocs, consoleWrites, fileWrites,
+                 static_cast<unsigned long long>(syncs), static_cast<unsigned long long>(gIo.opens.load()),
+                 ok ? "ok" : "OVER BUDGET");
+    std::fflush(report);
+
+    logger.flush_and_shutdown();
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+// The whole replaceable set, so every new-expression pairs with a counting delete
+namespace {
+
+void* counted_alloc(std::size_t size, std::size_t alignment)
+{
+    tAllocCounters->allocations.fetch_add(1, std::memory_order_relaxed);
+    size = (size != 0) ? size : 1;
+    void* p = (alignment <= alignof(std::max_align_t))
+            ? std::malloc(size)
+            : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// Out of line: inlined into a delete-expression, free() would look mismatched with new
+[[gnu::noinline]] void counted_free(void* p) noexcept
+{
+    if (p != nullptr) {
+        tAllocCounters->frees.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size, 0); }
+void* operator new[](std::size_t size) { return counted_alloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+
+int main(int argc, char** argv)
+{
+    const size_t messages = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::string directory = (argc > 2) ? argv[2] : "/tmp/kl_audit";
+
+    std::fprintf(stderr, "per message, steady state (%zu messages per mode)\n", messages);
+    std::fprintf(stderr, "%-24s %9s %9s %9s %9s %6s %6s\n", "mode", "prod_new", "work_new", "con_wr", "file_wr", "fsync", "open");
+    std::fflush(stderr);
+
+    int failures = 0;
+    for (const Mode& mode : kModes) {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+
+        const pid_t child = fork();
+        if (child == 0) {
+            std::_Exit(run_mode(mode, messages, directory));
+        }
+
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failures;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    std::fprintf(stderr, "%s\n", failures == 0 ? "all budgets met" : "budget violations found");
+    return failures == 0 ? 0 : 1;
+}
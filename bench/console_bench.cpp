@@ -0,0 +1,121 @@
+/**
+ * @file console_bench.cpp
+ * @brief Console sink into a pipe: with and without ANSI colors (Config::consoleColor), and
+ * with a console line cap.
+ *
+ * stdout is replaced by a pipe whose other end a reader thread drains, as a container
+ * runtime or log collector would. For ColorMode::Always and ColorMode::Never the program logs
+ * the same INFO lines through a fresh Logger and reports bytes that crossed the pipe and the
+ * process CPU time (minus the reader thread's) per million lines. ColorMode::Auto is checked
+ * to resolve to no color on the pipe. The "capped" row caps the console at 1000 INFO lines
+ * per second (Config::consoleLinesPerSecond, applied to the pipe as if it were a terminal).
+ *
+ * Usage: kl_bench_console [messages] [payload-bytes]
+ */
+
+#include <KL/Logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+double cpu_seconds(clockid_t clock)
+{
+    timespec ts{};
+    clock_gettime(clock, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+struct Result {
+    uint64_t bytes = 0;
+    double cpuSeconds = 0;
+    double seconds = 0;
+};
+
+Result run(KL::ColorMode mode, double consoleCap, size_t messages, const std::string& payload)
+{
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        std::exit(2);
+    }
+    const int savedStdout = dup(STDOUT_FILENO);
+    dup2(fds[1], STDOUT_FILENO);
+    close(fds[1]);
+
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<double> readerCpu{0};
+    std::thread reader([&bytes, &readerCpu, readFd = fds[0]]() {
+        const double start = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+        char buffer[64 * 1024];
+        ssize_t count = 0;
+        while ((count = read(readFd, buffer, sizeof(buffer))) > 0) {
+            bytes.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+        }
+        readerCpu.store(cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - start);
+    });
+
+    Result result;
+    {
+        KL::Config config;
+        config.crashHandler = false;
+        config.consoleColor = mode;
+        config.consoleLinesPerSecond[static_cast<size_t>(KL::Level::INFO)] = consoleCap;
+        config.consoleThrottleTerminalOnly = false;
+        KL::Logger logger(config);
+
+        const double cpuStart = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i) {
+            logger.log(KL::Level::INFO, payload, false);
+        }
+        logger.flush();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.cpuSeconds = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+    }
+
+    // Closing the last write end ends the reader
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+    reader.join();
+    close(fds[0]);
+
+    result.bytes = bytes.load();
+    result.cpuSeconds -= readerCpu.load();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t messages = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t payloadBytes = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 64;
+    const std::string payload(payloadBytes, 'x');
+
+    std::fprintf(stderr, "%-8s %14s %12s %16s %12s\n", "color", "bytes", "bytes/line", "cpu ms/M lines", "lines/s");
+    const struct {
+        const char* name;
+        KL::ColorMode mode;
+        double consoleCap;
+    } kModes[] = {{"always", KL::ColorMode::Always, 0}, {"never", KL::ColorMode::Never, 0},
+                  {"auto", KL::ColorMode::Auto, 0}, {"capped", KL::ColorMode::Auto, 1000}};
+
+    for (const auto& mode : kModes) {
+        const Result result = run(mode.mode, mode.consoleCap, messages, payload);
+        std::fprintf(stderr, "%-8s %14llu %12.1f %16.1f %12.0f\n", mode.name,
+                     static_cast<unsigned long long>(result.bytes),
+                     static_cast<double>(result.bytes) / static_cast<double>(messages),
+                     result.cpuSeconds * 1e3 * 1e6 / static_cast<double>(messages),
+                     static_cast<double>(messages) / result.seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file format_bench.cpp
+ * @brief KL::Format against snprintf, std::to_chars and std::ostringstream.
+ *
+ * Rows (nanoseconds per value, single thread, output appended to a reused buffer where the
+ * method allows it):
+ *   uint64 / int64 / double / pointer   one value of each kind, random inputs
+ *   message                             "request {} took {} ms from {} ok={}" (int, double,
+ *                                       pointer, bool)
+ * Columns: KL::Format, snprintf, std::to_chars (numbers only), std::ostringstream, and
+ * std::to_string concatenation for the message row.
+ * Then LOG_INFO with std::to_string concatenation against LOGF_INFO and LOGF_INFO_DEFERRED,
+ * producer side only.
+ *
+ * Usage: kl_bench_format [values]
+ * stdout is redirected to /dev/null; messages are console-only.
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+volatile size_t gSink = 0;
+
+template <typename Body>
+double ns_per_call(size_t calls, Body body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        body(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(calls);
+}
+
+void print_row(const char* name, double kl, double printf, double toChars, double stream, double toString = -1)
+{
+    auto cell = [](double value) {
+        static char text[5][16];
+        static int next = 0;
+        char* out = text[next++ % 5];
+        if (value < 0) {
+            std::snprintf(out, 16, "%s", "-");
+        }
+        else {
+            std::snprintf(out, 16, "%.1f", value);
+        }
+        return out;
+    };
+    std::fprintf(stderr, "%-10s %10s %10s %10s %10s %10s\n", name, cell(kl), cell(printf), cell(toChars), cell(stream), cell(toString));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t calls = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> unsignedValues(4096);
+    std::vector<int64_t> signedValues(4096);
+    std::vector<double> doubleValues(4096);
+    std::vector<const void*> pointerValues(4096);
+    for (size_t i = 0; i < unsignedValues.size(); ++i) {
+        unsignedValues[i] = random() >> (random() % 64);
+        signedValues[i] = static_cast<int64_t>(random() >> (random() % 64)) * ((i & 1) ? -1 : 1);
+        doubleValues[i] = std::uniform_real_distribution<double>(-1e6, 1e6)(random);
+        pointerValues[i] = reinterpret_cast<const void*>(static_cast<uintptr_t>(random() & 0x7FFFFFFFFFFFull));
+    }
+    const size_t mask = unsignedValues.size() - 1;
+
+    std::string out;
+    out.reserve(256);
+    char buffer[128];
+    std::ostringstream stream;
+
+    std::fprintf(stderr, "%-10s %10s %10s %10s %10s %10s\n", "ns/value", "KL::Format", "snprintf", "to_chars", "ostream", "to_string");
+
+    print_row("uint64",
+        ns_per_call(calls, [&](size_t i) { out.clear(); KL::Format::append(out, unsignedValues[i & mask]); gSink = gSink + out.size(); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(unsignedValues[i & mask])); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), unsignedValues[i & mask]).ptr - buffer); }),
+        ns_per_call(calls, [&](size_t i) { stream.str(std::string()); stream << unsignedValues[i & mask]; gSink = gSink + static_cast<size_t>(stream.tellp()); }));
+
+    print_row("int64",
+        ns_per_call(calls, [&](size_t i) { out.clear(); KL::Format::append(out, signedValues[i & mask]); gSink = gSink + out.size(); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(signedValues[i & mask])); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), signedValues[i & mask]).ptr - buffer); }),
+        ns_per_call(calls, [&](size_t i) { stream.str(std::string()); stream << signedValues[i & mask]; gSink = gSink + static_cast<size_t>(stream.tellp()); }));
+
+    // snprintf and ostream with the precision that round-trips, to compare like with like
+    print_row("double",
+        ns_per_call(calls, [&](size_t i) { out.clear(); KL::Format::append(out, doubleValues[i & mask]); gSink = gSink + out.size(); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + std::snprintf(buffer, sizeof(buffer), "%.17g", doubleValues[i & mask]); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), doubleValues[i & mask]).ptr - buffer); }),
+        ns_per_call(calls, [&](size_t i) { stream.str(std::string()); stream.precision(17); stream << doubleValues[i & mask]; gSink = gSink + static_cast<size_t>(stream.tellp()); }));
+
+    print_row("pointer",
+        ns_per_call(calls, [&](size_t i) { out.clear(); KL::Format::append(out, pointerValues[i & mask]); gSink = gSink + out.size(); }),
+        ns_per_call(calls, [&](size_t i) { gSink = gSink + std::snprintf(buffer, sizeof(buffer), "%p", pointerValues[i & mask]); }),
+        -1,
+        ns_per_call(calls, [&](size_t i) { stream.str(std::string()); stream << pointerValues[i & mask]; gSink = gSink + static_cast<size_t>(stream.tellp()); }));
+
+    print_row("message",
+        ns_per_call(calls, [&](size_t i) {
+            out.clear();
+            KL::format_to(out, "request {} took {} ms from {} ok={}", unsignedValues[i & mask], doubleValues[i & mask], pointerValues[i & mask], (i & 1) != 0);
+            gSink = gSink + out.size();
+        }),
+        ns_per_call(calls, [&](size_t i) {
+            gSink = gSink + std::snprintf(buffer, sizeof(buffer), "request %llu took %.17g ms from %p ok=%s",
+                                          static_cast<unsigned long long>(unsignedValues[i & mask]), doubleValues[i & mask],
+                                          pointerValues[i & mask], (i & 1) ? "true" : "false");
+        }),
+        -1,
+        ns_per_call(calls, [&](size_t i) {
+            stream.str(std::string());
+            stream.precision(17);
+            stream << "request " << unsignedValues[i & mask] << " took " << doubleValues[i & mask] << " ms from "
+                   << pointerValues[i & mask] << " ok=" << std::boolalpha << ((i & 1) != 0);
+            gSink = gSink + static_cast<size_t>(stream.tellp());
+        }),
+        ns_per_call(calls, [&](size_t i) {
+            const std::string text = "request " + std::to_string(unsignedValues[i & mask]) + " took " + std::to_string(doubleValues[i & mask])
+                                   + " ms ok=" + ((i & 1) ? "true" : "false");
+            gSink = gSink + text.size();
+        }));
+
+    KL::Config config;
+    config.crashHandler = false;
+    KL::Logger& logger = KL::Logger::get_instance();
+    logger.init(config);
+
+    // Fewer calls than above: every one of these queues a line for the worker to print
+    const size_t logCalls = calls / 10;
+    std::fprintf(stderr, "\n%-20s %10s\n", "producer", "ns/call");
+    std::fprintf(stderr, "%-20s %10.1f\n", "LOG_INFO to_string", ns_per_call(logCalls, [&](size_t i) {
+        LOG_INFO("request " + std::to_string(unsignedValues[i & mask]) + " took " + std::to_string(doubleValues[i & mask]) + " ms");
+    }));
+    logger.flush();
+    std::fprintf(stderr, "%-20s %10.1f\n", "LOGF_INFO", ns_per_call(logCalls, [&](size_t i) {
+        LOGF_INFO("request {} took {} ms", unsignedValues[i & mask], doubleValues[i & mask]);
+    }));
+    logger.flush();
+    std::fprintf(stderr, "%-20s %10.1f\n", "LOGF_INFO_DEFERRED", ns_per_call(logCalls, [&](size_t i) {
+        LOGF_INFO_DEFERRED("request {} took {} ms", unsignedValues[i & mask], doubleValues[i & mask]);
+    }));
+
+    logger.flush_and_shutdown();
+    return 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file kl_bench.cpp
+ * @brief Producer latency and end-to-end throughput of the logger.
+ *
+ * For every (sink, message size, thread count) combination the program logs a fixed number of
+ * messages, waits for Logger::flush(), and reports:
+ *   - per-call producer latency of log() (p50/p99/p999/max, timed with rdtsc where available)
+ *   - sustained throughput (lines/s and MB/s, first call to flush() returning)
+ *   - worker CPU time per million lines (process CPU minus the producer threads' CPU)
+ *
+ * stdout is redirected to /dev/null and log files go to a tmpfs directory by default, so the
+ * numbers describe the library rather than the terminal or the disk.
+ *
+ * Usage: kl_bench [--threads N] [--messages N] [--format csv|json] [--out FILE] [--dir DIR]
+ *                 [--batch-delay-us N] [--batch-min N]
+ *   --threads N   Highest producer count; runs 1, 2, 4, ... N (default: hardware threads, max 8)
+ *   --messages N  Messages per run (default 200000; capped at 64 MiB of payload per run)
+ *   --format F    csv (default) or json
+ *   --out FILE    Result file (default: stderr)
+ *   --dir DIR     Log directory (default: /dev/shm/kl_bench if available)
+ *   --batch-delay-us N, --batch-min N   Config::batchMaxDelay / batchMinEntries (default: scheduler off)
+ *
+ * Batch sizes achieved in each run are reported from Logger::stats() (instrumented builds).
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define KL_BENCH_RDTSC 1
+#else
+    #define KL_BENCH_RDTSC 0
+#endif
+
+namespace {
+
+/// Cycle counter where available, steady_clock nanoseconds elsewhere
+inline uint64_t ticks() noexcept
+{
+    #if KL_BENCH_RDTSC
+        return __rdtsc();
+    #else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    #endif
+}
+
+/// Ticks per nanosecond, measured against steady_clock
+double calibrate_ticks_per_ns()
+{
+    #if KL_BENCH_RDTSC
+        const auto wallStart = std::chrono::steady_clock::now();
+        const uint64_t tickStart = ticks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const uint64_t tickEnd = ticks();
+        const auto wallNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wallStart).count();
+        return static_cast<double>(tickEnd - tickStart) / wallNanos;
+    #else
+        return 1.0;
+    #endif
+}
+
+/// CPU time of the calling thread / of the whole process, in seconds (0 where unsupported)
+double cpu_seconds(bool wholeProcess)
+{
+    #if defined(CLOCK_THREAD_CPUTIME_ID) && defined(CLOCK_PROCESS_CPUTIME_ID)
+        timespec ts{};
+        clock_gettime(wholeProcess ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+    #else
+        (void)wholeProcess;
+        return 0.0;
+    #endif
+}
+
+struct Options {
+    size_t maxThreads = 0;
+    size_t messages = 200000;
+    bool json = false;
+    std::string outPath;
+    std::string directory;
+    long batchDelayUs = 0;
+    size_t batchMin = 0;
+};
+
+struct Result {
+    const char* sink;
+    size_t size;
+    size_t threads;
+    size_t messages;
+    double seconds;
+    double p50Ns, p99Ns, p999Ns, maxNs;
+    double workerCpuMsPerMillion;
+    double meanBatch;
+    uint64_t p99Batch;
+};
+
+/// Logs `messages` entries of `size` bytes from `threads` producers and waits for the flush
+Result run(bool toFile, size_t size, size_t threads, size_t messages, double ticksPerNs)
+{
+    KL::Logger& logger = KL::Logger::get_instance();
+    const std::string payload(size, 'x');
+    const KL::LoggerStats before = logger.stats();
+    const size_t perThread = messages / threads;
+
+    std::vector<std::vector<uint64_t>> samples(threads);
+    std::vector<double> producerCpu(threads, 0.0);
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+
+    auto producer = [&](size_t index) {
+        auto& latencies = samples[index];
+        latencies.resize(perThread);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        const double cpuStart = cpu_seconds(false);
+        for (size_t i = 0; i < perThread; ++i) {
+            const uint64_t start = ticks();
+            if (toFile) {
+                FLOG_INFO(payload);
+            }
+            else {
+                LOG_INFO(payload);
+            }
+            latencies[i] = ticks() - start;
+        }
+        producerCpu[index] = cpu_seconds(false) - cpuStart;
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(producer, t);
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+
+    const double processCpuStart = cpu_seconds(true);
+    const double mainCpuStart = cpu_seconds(false);
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    logger.flush();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double workerCpu = (cpu_seconds(true) - processCpuStart) - (cpu_seconds(false) - mainCpuStart);
+    for (double cpu : producerCpu) {
+        workerCpu -= cpu;
+    }
+
+    std::vector<uint64_t> all;
+    all.reserve(perThread * threads);
+    for (const auto& latencies : samples) {
+        all.insert(all.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    const auto percentile = [&all, ticksPerNs](double q) {
+        const size_t index = std::min(all.size() - 1, static_cast<size_t>(q * static_cast<double>(all.size())));
+        return static_cast<double>(all[index]) / ticksPerNs;
+    };
+
+    Result result{};
+    result.sink = toFile ? "file" : "console";
+    result.size = size;
+    result.threads = threads;
+    result.messages = all.size();
+    result.seconds = seconds;
+    result.p50Ns = percentile(0.50);
+    result.p99Ns = percentile(0.99);
+    result.p999Ns = percentile(0.999);
+    result.maxNs = static_cast<double>(all.back()) / ticksPerNs;
+    result.workerCpuMsPerMillion = std::max(0.0, workerCpu) * 1e3 * 1e6 / static_cast<double>(all.size());
+
+    // Batch sizes of this run only (the histogram is cumulative; the mean is exact, p99 is since start)
+    const KL::LoggerStats after = logger.stats();
+    const uint64_t batches = after.batches - before.batches;
+    result.meanBatch = batches ? static_cast<double>(after.batchSize.sum - before.batchSize.sum) / static_cast<double>(batches) : 0.0;
+    result.p99Batch = after.batchSize.p99;
+    return result;
+}
+
+void write_results(std::FILE* out, const std::vector<Result>& results, bool json)
+{
+    if (json) {
+        std::fprintf(out, "[\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::fprintf(out,
+                "  {\"sink\":\"%s\",\"msg_bytes\":%zu,\"threads\":%zu,\"messages\":%zu,"
+                "\"lines_per_sec\":%.0f,\"mb_per_sec\":%.2f,\"p50_ns\":%.1f,\"p99_ns\":%.1f,"
+                "\"p999_ns\":%.1f,\"max_ns\":%.1f,\"worker_cpu_ms_per_mline\":%.1f,"
+                "\"mean_batch\":%.1f,\"p99_batch\":%llu}%s\n",
+                r.sink, r.size, r.threads, r.messages,
+                static_cast<double>(r.messages) / r.seconds,
+                static_cast<double>(r.messages * r.size) / r.seconds / 1e6,
+                r.p50Ns, r.p99Ns, r.p999Ns, r.maxNs, r.workerCpuMsPerMillion,
+                r.meanBatch, static_cast<unsigned long long>(r.p99Batch),
+                (i + 1 < results.size()) ? "," : "");
+        }
+        std::fprintf(out, "]\n");
+        return;
+    }
+
+    std::fprintf(out, "sink,msg_bytes,threads,messages,lines_per_sec,mb_per_sec,p50_ns,p99_ns,p999_ns,max_ns,worker_cpu_ms_per_mline,mean_batch,p99_batch\n");
+    for (const Result& r : results) {
+        std::fprintf(out, "%s,%zu,%zu,%zu,%.0f,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%llu\n",
+                     r.sink, r.size, r.threads, r.messages,
+                     static_cast<double>(r.messages) / r.seconds,
+                     static_cast<double>(r.messages * r.size) / r.seconds / 1e6,
+                     r.p50Ns, r.p99Ns, r.p999Ns, r.maxNs, r.workerCpuMsPerMillion,
+                     r.meanBatch, static_cast<unsigned long long>(r.p99Batch));
+    }
+}
+
+bool parse(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--threads" && hasValue)       { options.maxThreads = std::strtoul(argv[++i], nullptr, 10); }
+        else if (arg == "--messages" && hasValue) { options.messages = std::strtoul(argv[++i], nullptr, 10); }
+        else if (arg == "--format" && hasValue)   { options.json = (std::string(argv[++i]) == "json"); }
+        else if (arg == "--out" && hasValue)      { options.outPath = argv[++i]; }
+        else if (arg == "--dir" && hasValue)      { options.directory = argv[++i]; }
+        else if (arg == "--batch-delay-us" && hasValue) { options.batchDelayUs = std::strtol(argv[++i], nullptr, 10); }
+        else if (arg == "--batch-min" && hasValue)      { options.batchMin = std::strtoul(argv[++i], nullptr, 10); }
+        else { return false; }
+    }
+    return options.messages > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--threads N] [--messages N] [--format csv|json] [--out FILE] [--dir DIR]"
+                             " [--batch-delay-us N] [--batch-min N]\n", argv[0]);
+        return 2;
+    }
+    if (options.maxThreads == 0) {
+        options.maxThreads = std::min<size_t>(8, std::max(1u, std::thread::hardware_concurrency()));
+    }
+    if (options.directory.empty()) {
+        std::error_code ec;
+        options.directory = std::filesystem::is_directory("/dev/shm", ec)
+            ? "/dev/shm/kl_bench" : (std::filesystem::temp_directory_path() / "kl_bench").string();
+    }
+
+    std::FILE* out = options.outPath.empty() ? stderr : std::fopen(options.outPath.c_str(), "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", options.outPath.c_str());
+        return 1;
+    }
+    // Console sink output must not reach a terminal
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        std::fprintf(stderr, "cannot redirect stdout to /dev/null\n");
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(options.directory, ec);
+
+    KL::Config config;
+    config.folderPath = options.directory;
+    config.maxLinesPerFile = 20000;   // Keeps the space pinned by the open (unlinked) file small
+    config.crashHandler = false;
+    config.batchMaxDelay = std::chrono::microseconds(options.batchDelayUs);
+    config.batchMinEntries = options.batchMin;
+    KL::Logger::get_instance().init(config);
+
+    const double ticksPerNs = calibrate_ticks_per_ns();
+
+    std::vector<Result> results;
+    for (bool toFile : {false, true}) {
+        for (size_t size : {16, 64, 256, 1024, 4096}) {
+            const size_t messages = std::min(options.messages, (size_t{64} << 20) / size);
+            for (size_t threads = 1; threads <= options.maxThreads; threads *= 2) {
+                results.push_back(run(toFile, size, threads, std::max(messages, threads), ticksPerNs));
+
+                // Free tmpfs space between runs; the logger keeps appending to its current descriptor
+                for (const auto& file : std::filesystem::directory_iterator(options.directory, ec)) {
+                    std::filesystem::remove(file.path(), ec);
+                }
+            }
+        }
+    }
+
+    write_results(out, results, options.json);
+    if (out != stderr) {
+        std::fclose(out);
+    }
+
+    KL::Logger::get_instance().flush_and_shutdown();
+    std::filesystem::remove_all(options.directory, ec);
+    return 0;
+}
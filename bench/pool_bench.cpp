@@ -0,0 +1,123 @@
+/**
+ * @file pool_bench.cpp
+ * @brief Throughput of 1, 8 and 64 logger instances drained by a shared WorkerPool of
+ * 1..N threads, against one dedicated worker thread per logger.
+ *
+ * Producers spread their messages round-robin over the loggers; a run ends when every
+ * logger has flushed. Every logger writes its own file (filePrefix) under the log directory.
+ *
+ * Usage: kl_bench_pool [messages-per-producer] [producers] [log-dir]
+ * stdout is redirected to /dev/null.
+ */
+
+#include <KL/Logger.h>
+#include <KL/WorkerPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kLoggerCounts[] = {1, 8, 64};
+
+double process_cpu_seconds()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+/// One run; poolThreads == 0 gives every logger its own worker thread
+void run(size_t loggerCount, size_t poolThreads, size_t producers, size_t messages, const std::string& directory)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    std::shared_ptr<KL::WorkerPool> pool;
+    if (poolThreads != 0) {
+        pool = std::make_shared<KL::WorkerPool>(poolThreads);
+    }
+
+    std::vector<std::unique_ptr<KL::Logger>> loggers;
+    for (size_t i = 0; i < loggerCount; ++i) {
+        KL::Config config;
+        config.folderPath = directory;
+        config.filePrefix = "bench" + std::to_string(i);
+        config.maxLinesPerFile = messages * producers + 1;
+        config.queueCapacity = 4096;
+        config.crashHandler = false;
+        config.workerPool = pool;
+        loggers.push_back(std::make_unique<KL::Logger>(config));
+    }
+    pool.reset();   // The loggers keep it alive
+
+    const std::string payload(64, 'x');
+    const double cpuStart = process_cpu_seconds();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (size_t i = 0; i < messages; ++i) {
+                loggers[(p + i) % loggerCount]->log(KL::Level::INFO, payload, true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& logger : loggers) {
+        logger->flush();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cpu = process_cpu_seconds() - cpuStart;
+    const double total = static_cast<double>(messages * producers);
+
+    std::fprintf(stderr, "%7zu %7s %9.0f %9.3f %10.0f %7.0f%%\n",
+                 loggerCount, poolThreads ? std::to_string(poolThreads).c_str() : "own",
+                 total, seconds, total / seconds, 100.0 * cpu / seconds);
+    std::fflush(stderr);
+
+    loggers.clear();
+    std::filesystem::remove_all(directory, ec);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t messages = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+    const size_t producers = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : std::min<size_t>(4, cpus);
+    const std::string directory = (argc > 3) ? argv[3] : "/dev/shm/kl_bench_pool";
+
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t <= cpus && t <= 8; t *= 2) {
+        threadCounts.push_back(t);
+    }
+
+    std::fprintf(stderr, "%zu producers x %zu messages\n", producers, messages);
+    std::fprintf(stderr, "%7s %7s %9s %9s %10s %8s\n", "loggers", "threads", "msgs", "seconds", "msgs/s", "cpu");
+    std::fflush(stderr);
+
+    for (size_t loggerCount : kLoggerCounts) {
+        for (size_t threads : threadCounts) {
+            run(loggerCount, threads, producers, messages, directory);
+        }
+        run(loggerCount, 0, producers, messages, directory);
+    }
+    return 0;
+}
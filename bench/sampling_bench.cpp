@@ -0,0 +1,101 @@
+/**
+ * @file sampling_bench.cpp
+ * @brief Cost of the *_SAMPLED macros when the line is not kept, and accuracy of the
+ * rescaled counts.
+ *
+ * Rows (nanoseconds per call, single producer, message built with std::to_string):
+ *   loop          the benchmark loop alone
+ *   keep(1000)    KL::Sampling::keep() by itself
+ *   sampled 1/N   LOG_INFO_SAMPLED(N, ...) - almost every call takes the not-kept path
+ *   unsampled     LOG_INFO(...) for comparison
+ * then, per rate, lines actually written x rate against the number of calls.
+ *
+ * Usage: kl_bench_sampling [calls]
+ * stdout is redirected to /dev/null; messages are console-only.
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+volatile uint64_t gSink = 0;
+
+template <typename Body>
+double ns_per_call(size_t calls, Body body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        body(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(calls);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t calls = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    KL::Config config;
+    config.crashHandler = false;
+    KL::Logger& logger = KL::Logger::get_instance();
+    logger.init(config);
+
+    std::fprintf(stderr, "%-16s %10s\n", "path", "ns/call");
+    std::fprintf(stderr, "%-16s %10.2f\n", "loop", ns_per_call(calls, [](size_t i) { gSink = gSink + i; }));
+    std::fprintf(stderr, "%-16s %10.2f\n", "keep(1000)", ns_per_call(calls, [](size_t) { gSink = gSink + KL::Sampling::keep(1000); }));
+
+    constexpr uint32_t kRates[] = {10, 100, 1000};
+    uint64_t written[sizeof(kRates) / sizeof(kRates[0])]{};
+
+    for (size_t r = 0; r < sizeof(kRates) / sizeof(kRates[0]); ++r) {
+        const uint32_t rate = kRates[r];
+        logger.flush();
+        const uint64_t before = logger.stats().written;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "sampled 1/%u", rate);
+        std::fprintf(stderr, "%-16s %10.2f\n", name, ns_per_call(calls, [rate](size_t i) {
+            LOG_INFO_SAMPLED(rate, "request " + std::to_string(i) + " served");
+        }));
+
+        logger.flush();
+        written[r] = logger.stats().written - before;
+    }
+
+    const size_t plainCalls = calls / 10;
+    std::fprintf(stderr, "%-16s %10.2f\n", "unsampled", ns_per_call(plainCalls, [](size_t i) {
+        LOG_INFO("request " + std::to_string(i) + " served");
+    }));
+    logger.flush();
+
+    if (!logger.stats().enabled) {
+        std::fprintf(stderr, "(built with KL_DISABLE_METRICS: no written counts)\n");
+        return 0;
+    }
+
+    std::fprintf(stderr, "\n%-8s %10s %12s %12s %8s\n", "rate", "written", "estimate", "calls", "error");
+    for (size_t r = 0; r < sizeof(kRates) / sizeof(kRates[0]); ++r) {
+        const double estimate = static_cast<double>(written[r]) * kRates[r];
+        // One binomial standard deviation of the estimate: sqrt(calls * (rate - 1))
+        const double sigma = std::sqrt(static_cast<double>(calls) * (kRates[r] - 1));
+        std::fprintf(stderr, "1/%-6u %10llu %12.0f %12zu %+7.2f%% (1 sigma %.2f%%)\n", kRates[r],
+                     static_cast<unsigned long long>(written[r]), estimate, calls,
+                     100.0 * (estimate - static_cast<double>(calls)) / static_cast<double>(calls),
+                     100.0 * sigma / static_cast<double>(calls));
+    }
+
+    logger.flush_and_shutdown();
+    return 0;
+}
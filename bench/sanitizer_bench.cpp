@@ -0,0 +1,130 @@
+/**
+ * @file sanitizer_bench.cpp
+ * @brief Throughput of KL::Sanitizer (GB/s) against a byte-at-a-time loop.
+ *
+ * Usage: kl_bench_sanitizer [megabytes-per-run]
+ */
+
+#include <KL/Sanitizer.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The obvious implementation: look at every byte, append every byte
+void naive_sanitize(std::string& out, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        const auto c = static_cast<unsigned char>(data[i]);
+        if (c < 0x20 || c > 0x7E) {
+            const size_t utf8 = (c >= 0x80) ? KL::Sanitizer::utf8_sequence_length(data + i, size - i) : 0;
+            if (utf8 != 0) {
+                out.append(data + i, utf8);
+                i += utf8 - 1;
+            }
+            else {
+                KL::Sanitizer::append_escape(out, c);
+            }
+        }
+        else {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+/// Builds messages of the given length; every `dirtyEvery`-th message gets a newline and a UTF-8 char
+std::vector<std::string> make_messages(size_t length, size_t count, size_t dirtyEvery)
+{
+    std::vector<std::string> messages;
+    messages.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string msg;
+        msg.reserve(length);
+        while (msg.size() < length) {
+            msg += static_cast<char>('a' + (msg.size() * 7 + i) % 26);
+        }
+        if (dirtyEvery != 0 && i % dirtyEvery == 0) {
+            msg[length / 2] = '\n';
+            msg.replace(length / 3, 2, "\xC3\xA9"); // U+00E9
+        }
+        messages.push_back(std::move(msg));
+    }
+    return messages;
+}
+
+volatile size_t gSink = 0; // Defeats dead-code elimination
+
+template <typename Fn>
+double measure_gbps(const std::vector<std::string>& messages, size_t targetBytes, Fn&& fn)
+{
+    size_t perPass = 0;
+    for (const auto& m : messages) {
+        perPass += m.size();
+    }
+    const size_t passes = (targetBytes + perPass - 1) / perPass;
+
+    std::string out;
+    out.reserve(8192);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < passes; ++p) {
+        for (const auto& m : messages) {
+            out.clear();
+            fn(out, m);
+            gSink = gSink + out.size();
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(passes * perPass) / elapsed / 1e9;
+}
+
+template <typename ScanFn>
+double measure_scan_gbps(const std::vector<std::string>& messages, size_t targetBytes, ScanFn scan)
+{
+    return measure_gbps(messages, targetBytes, [scan](std::string&, const std::string& m) {
+        gSink = gSink + scan(m.data(), m.size());
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const size_t targetBytes = megabytes * 1024 * 1024;
+
+    #if KL_SANITIZER_X86
+        std::printf("cpu: avx2=%s\n", KL::Sanitizer::cpu_has_avx2() ? "yes" : "no");
+    #endif
+    std::printf("%-8s %-6s %-14s %10s\n", "msg_len", "input", "impl", "GB/s");
+
+    for (size_t length : {16, 64, 256, 1024, 4096}) {
+        for (size_t dirtyEvery : {size_t{0}, size_t{8}}) {
+            const auto messages = make_messages(length, 1024, dirtyEvery);
+            const char* input = dirtyEvery ? "mixed" : "clean";
+
+            auto report = [&](const char* impl, double gbps) {
+                std::printf("%-8zu %-6s %-14s %10.2f\n", length, input, impl, gbps);
+            };
+
+            report("naive", measure_gbps(messages, targetBytes, [](std::string& out, const std::string& m) {
+                naive_sanitize(out, m.data(), m.size());
+            }));
+            report("sanitize", measure_gbps(messages, targetBytes, [](std::string& out, const std::string& m) {
+                KL::Sanitizer::append_sanitized(out, m);
+            }));
+            report("scan_scalar", measure_scan_gbps(messages, targetBytes, &KL::Sanitizer::scan_scalar));
+            #if KL_SANITIZER_X86
+                report("scan_sse2", measure_scan_gbps(messages, targetBytes, &KL::Sanitizer::scan_sse2));
+                if (KL::Sanitizer::cpu_has_avx2()) {
+                    report("scan_avx2", measure_scan_gbps(messages, targetBytes, &KL::Sanitizer::scan_avx2));
+                }
+            #endif
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file syslog_bench.cpp
+ * @brief Syslog sink (Config::syslogProtocol) against a stand-in listener.
+ *
+ * The program binds its own AF_UNIX datagram socket in /tmp in place of /dev/log or the
+ * journald socket; a reader thread counts what arrives and keeps the first datagram, which is
+ * printed for each protocol (newlines shown as "\n"). Rows:
+ *   rfc5424 / journald   reader running
+ *   stalled              reader started only after the logger is done: the socket queue fills
+ *                        (net.unix.max_dgram_qlen) and the rest is dropped, never blocking
+ *   no-listener          nothing bound at the path: everything is dropped
+ * Columns: LoggerStats::syslogSent / syslogDropped, datagrams received, and lines/s through the
+ * logger including flush().
+ *
+ * Usage: kl_bench_syslog [messages] [payload-bytes]
+ * stdout is redirected to /dev/null; messages are console-only.
+ */
+
+#include <KL/Logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct Result {
+    KL::LoggerStats stats;
+    uint64_t received = 0;
+    double seconds = 0;
+    std::string first;
+};
+
+/// Stand-in for journald / rsyslog: counts datagrams until stopped
+class Listener {
+public:
+    explicit Listener(const std::string& path) : mPath(path)
+    {
+        ::unlink(mPath.c_str());
+        mFd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", mPath.c_str());
+        if (mFd < 0 || ::bind(mFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            std::perror("bind");
+            std::exit(2);
+        }
+        timeval timeout{0, 50 * 1000};
+        ::setsockopt(mFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~Listener()
+    {
+        stop();
+        ::close(mFd);
+        ::unlink(mPath.c_str());
+    }
+
+    void start()
+    {
+        mThread = std::thread([this]() {
+            char buffer[64 * 1024];
+            while (!mStop.load(std::memory_order_relaxed)) {
+                const ssize_t count = ::recv(mFd, buffer, sizeof(buffer), 0);
+                if (count < 0) {
+                    continue;
+                }
+                if (mReceived.fetch_add(1, std::memory_order_relaxed) == 0) {
+                    mFirst.assign(buffer, static_cast<size_t>(count));
+                }
+            }
+        });
+    }
+
+    /// Waits until nothing has arrived for a while, then stops the reader
+    void stop()
+    {
+        if (!mThread.joinable()) {
+            return;
+        }
+        uint64_t seen = ~uint64_t{0};
+        while (seen != mReceived.load()) {
+            seen = mReceived.load();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        mStop = true;
+        mThread.join();
+    }
+
+    uint64_t received() const { return mReceived.load(); }
+    const std::string& first() const { return mFirst; }
+
+private:
+    std::string mPath;
+    int mFd{-1};
+    std::thread mThread;
+    std::atomic<bool> mStop{false};
+    std::atomic<uint64_t> mReceived{0};
+    std::string mFirst;
+};
+
+Result run(KL::SyslogProtocol protocol, bool listen, bool stalled, size_t messages, const std::string& payload)
+{
+    const std::string path = "/tmp/kl_bench_syslog." + std::to_string(::getpid());
+    Result result;
+
+    Listener* listener = listen ? new Listener(path) : nullptr;
+    if (listener != nullptr && !stalled) {
+        listener->start();
+    }
+
+    {
+        KL::Config config;
+        config.crashHandler = false;
+        config.syslogProtocol = protocol;
+        config.syslogSocketPath = path;
+        config.syslogIdentifier = "kl_bench_syslog";
+        KL::Logger logger(config);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i) {
+            logger.log(KL::Level::INFO, payload, false);
+        }
+        logger.flush();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.stats = logger.stats();
+    }
+
+    if (listener != nullptr) {
+        if (stalled) {
+            listener->start();
+        }
+        listener->stop();
+        result.received = listener->received();
+        result.first = listener->first();
+        delete listener;
+    }
+    return result;
+}
+
+std::string printable(const std::string& datagram)
+{
+    std::string text;
+    for (const char c : datagram) {
+        if (c == '\n') {
+            text += "\\n";
+        }
+        else {
+            text += c;
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t messages = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t payloadBytes = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 64;
+    const std::string payload(payloadBytes, 'x');
+
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    const struct {
+        const char* name;
+        KL::SyslogProtocol protocol;
+        bool listen;
+        bool stalled;
+    } kRows[] = {{"rfc5424", KL::SyslogProtocol::Rfc5424, true, false},
+                 {"journald", KL::SyslogProtocol::Journald, true, false},
+                 {"stalled", KL::SyslogProtocol::Rfc5424, true, true},
+                 {"no-listener", KL::SyslogProtocol::Rfc5424, false, false}};
+
+    std::string samples;
+    std::fprintf(stderr, "%-12s %12s %12s %12s %12s\n", "row", "sent", "dropped", "received", "lines/s");
+    for (const auto& row : kRows) {
+        const Result result = run(row.protocol, row.listen, row.stalled, messages, payload);
+        std::fprintf(stderr, "%-12s %12llu %12llu %12llu %12.0f\n", row.name,
+                     static_cast<unsigned long long>(result.stats.syslogSent),
+                     static_cast<unsigned long long>(result.stats.syslogDropped),
+                     static_cast<unsigned long long>(result.received),
+                     static_cast<double>(messages) / result.seconds);
+        if (!row.stalled && !result.first.empty()) {
+            samples += std::string(row.name) + ": " + printable(result.first) + "\n";
+        }
+    }
+    std::fprintf(stderr, "\n%s", samples.c_str());
+    return 0;
+}
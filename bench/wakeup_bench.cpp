@@ -0,0 +1,140 @@
+/**
+ * @file wakeup_bench.cpp
+ * @brief Producer latency of log() per worker WaitStrategy at low, medium and burst rates.
+ *
+ * Each strategy runs in a forked child (WaitStrategy is fixed at init). At paced rates the
+ * producer sleeps between messages, so with WaitStrategy::Block nearly every call finds the
+ * worker asleep and pays the wake-up; Adaptive and BusyPoll trade worker CPU for skipping it.
+ *
+ * Usage: kl_bench_wakeup [block|adaptive|busy|all] [messages-per-rate]
+ * stdout is redirected to /dev/null; messages are console-only.
+ */
+
+#include <KL/Logger.h>
+#include <KL/Macros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Strategy {
+    const char* name;
+    KL::WaitStrategy strategy;
+};
+
+constexpr Strategy kStrategies[] = {
+    {"block",    KL::WaitStrategy::Block},
+    {"adaptive", KL::WaitStrategy::Adaptive},
+    {"busy",     KL::WaitStrategy::BusyPoll},
+};
+
+struct Rate {
+    const char* name;
+    long messagesPerSecond;     // 0 = back to back
+};
+
+constexpr Rate kRates[] = {
+    {"low (1k/s)",     1000},
+    {"medium (50k/s)", 50000},
+    {"burst",          0},
+};
+
+double process_cpu_seconds()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+int run_strategy(const Strategy& strategy, size_t messages)
+{
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 2;
+    }
+
+    KL::Config config;
+    config.waitStrategy = strategy.strategy;
+    config.crashHandler = false;
+    KL::Logger& logger = KL::Logger::get_instance();
+    logger.init(config);
+
+    const std::string payload(64, 'x');
+    std::vector<uint64_t> latencies(messages);
+
+    for (const Rate& rate : kRates) {
+        const size_t count = rate.messagesPerSecond ? std::min<size_t>(messages, static_cast<size_t>(rate.messagesPerSecond)) : messages;
+        const auto period = std::chrono::nanoseconds(rate.messagesPerSecond ? 1000000000L / rate.messagesPerSecond : 0);
+
+        logger.flush();
+        const double cpuStart = process_cpu_seconds();
+        const auto wallStart = std::chrono::steady_clock::now();
+        auto next = wallStart;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (rate.messagesPerSecond) {
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+            const auto start = std::chrono::steady_clock::now();
+            LOG_INFO(payload);
+            latencies[i] = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+        logger.flush();
+
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        const double cpu = process_cpu_seconds() - cpuStart;
+
+        std::sort(latencies.begin(), latencies.begin() + static_cast<std::ptrdiff_t>(count));
+        const auto at = [&](double q) {
+            return static_cast<unsigned long long>(latencies[std::min(count - 1, static_cast<size_t>(q * static_cast<double>(count)))]);
+        };
+        std::fprintf(stderr, "%-9s %-15s %8zu %8llu %8llu %8llu %10llu %7.0f%%\n",
+                     strategy.name, rate.name, count, at(0.50), at(0.99), at(0.999),
+                     static_cast<unsigned long long>(latencies[count - 1]), 100.0 * cpu / wall);
+        std::fflush(stderr);
+    }
+
+    logger.flush_and_shutdown();
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* only = (argc > 1 && std::strcmp(argv[1], "all") != 0) ? argv[1] : nullptr;
+    const size_t messages = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    std::fprintf(stderr, "%-9s %-15s %8s %8s %8s %8s %10s %8s\n",
+                 "strategy", "rate", "msgs", "p50_ns", "p99_ns", "p999_ns", "max_ns", "cpu");
+    std::fflush(stderr);
+
+    int failures = 0;
+    for (const Strategy& strategy : kStrategies) {
+        if (only != nullptr && std::strcmp(only, strategy.name) != 0) {
+            continue;
+        }
+
+        const pid_t child = fork();
+        if (child == 0) {
+            std::_Exit(run_strategy(strategy, messages));
+        }
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint32_t
+#include <cstring>          // For std::memcpy
+#include <new>              // For std::launder
+#include <string>           // For std::string
+#include <string_view>      // For std::string_view
+#include <type_traits>      // For std::is_trivially_copyable_v
+
+#include "Format.h"
+
+namespace KL {
+
+/**
+ * @brief Customization point: how an argument of the LOGF_*_DEFERRED macros is stored in the
+ * entry's argument bytes on the producer and turned into text on the worker.
+ *
+ * The primary template covers:
+ *   - text (C strings, char arrays, std::string, std::string_view): length + bytes
+ *   - trivially copyable types: their bytes, rendered by Format::append(), i.e. built-ins,
+ *     pointers and any type with a KL::Formatter; nothing but a Formatter is needed to move
+ *     such a type's formatting off the calling thread
+ *   - other types with a KL::Formatter: formatted on the producer, stored as text
+ *
+ * Anything else specializes Codec itself:
+ *
+ *     template <> struct KL::Codec<Packet> {
+ *         // Appends the bytes render() needs; runs on the logging thread
+ *         static void encode(std::string& bytes, const Packet& p);
+ *         // Appends the text and returns the end of this value's bytes; runs on the worker.
+ *         // data is not aligned: read fields with std::memcpy
+ *         static const char* render(std::string& out, const char* data);
+ *     };
+ *
+ * Encoded values must not point at anything the caller may free before the worker runs.
+ */
+template <typename T, typename Enable = void>
+struct Codec {
+    static void encode(std::string& bytes, const T& value)
+    {
+        if constexpr (is_text) {
+            append_text(bytes, text_of(value));
+        }
+        else if constexpr (std::is_trivially_copyable_v<T>) {
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        else if constexpr (Format::kHasFormatter<T>) {
+            // Reserve the length, format in place, then patch the length
+            const size_t start = bytes.size();
+            bytes.append(sizeof(uint32_t), '\0');
+            Formatter<T>::format(bytes, value);
+            const uint32_t length = static_cast<uint32_t>(bytes.size() - start - sizeof(uint32_t));
+            std::memcpy(&bytes[start], &length, sizeof(length));
+        }
+        else {
+            static_assert(sizeof(T) == 0, "KL::Codec: specialize KL::Codec or KL::Formatter for this type");
+        }
+    }
+
+    static const char* render(std::string& out, const char* data)
+    {
+        if constexpr (std::is_trivially_copyable_v<T> && !is_text) {
+            // Copied into aligned storage: T need not be default constructible
+            alignas(T) unsigned char storage[sizeof(T)];
+            std::memcpy(storage, data, sizeof(T));
+            Format::append(out, *std::launder(reinterpret_cast<const T*>(storage)));
+            return data + sizeof(T);
+        }
+        else {
+            uint32_t length = 0;
+            std::memcpy(&length, data, sizeof(length));
+            out.append(data + sizeof(length), length);
+            return data + sizeof(length) + length;
+        }
+    }
+
+private:
+    static constexpr bool is_text = std::is_same_v<T, char*> || std::is_same_v<T, const char*>
+                                 || std::is_convertible_v<const T&, std::string_view>;
+
+    static std::string_view text_of(const T& value)
+    {
+        if constexpr (std::is_pointer_v<T>) {
+            return (value != nullptr) ? std::string_view(value) : std::string_view("(null)");
+        }
+        else {
+            return std::string_view(value);
+        }
+    }
+
+    static void append_text(std::string& bytes, std::string_view text)
+    {
+        const uint32_t length = static_cast<uint32_t>(text.size());
+        bytes.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        bytes.append(text.data(), text.size());
+    }
+};
+
+/// Renders a message's argument bytes into out (stored in LogEntry::render)
+using EncodedRenderer = void (*)(std::string& out, std::string_view bytes);
+
+/**
+ * @brief A format string and its arguments as bytes: the producer half of LOGF_*_DEFERRED.
+ *
+ * Layout: the format string's pointer and length (it must be a literal or otherwise outlive
+ * the logger), then every argument through its Codec.
+ */
+namespace Encoding {
+
+    namespace detail {
+        struct Header {
+            const char* format;
+            size_t formatSize;
+        };
+    }
+
+    /// The Codec an argument of type T goes through: decayed, char arrays as const char*
+    template <typename T>
+    using Argument = std::conditional_t<std::is_same_v<std::decay_t<T>, char*>, const char*, std::decay_t<T>>;
+
+    /// Appends fmt and args to bytes; render<Argument<Args>...> is the matching EncodedRenderer
+    template <typename... Args>
+    void encode(std::string& bytes, std::string_view fmt, const Args&... args)
+    {
+        const detail::Header header{fmt.data(), fmt.size()};
+        bytes.reserve(bytes.size() + sizeof(header) + (sizeof(Argument<Args>) + ... + 0));
+        bytes.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        (Codec<Argument<Args>>::encode(bytes, args), ...);
+    }
+
+    /// Appends the text of a message produced by encode() with arguments of these Codec types
+    template <typename... Args>
+    void render(std::string& out, std::string_view bytes)
+    {
+        using RenderArgument = const char* (*)(std::string&, const char*);
+        static constexpr RenderArgument kRenderers[sizeof...(Args) + 1] = {&Codec<Args>::render..., nullptr};
+
+        detail::Header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        // substitute() asks for the arguments in order, so one cursor walks the bytes
+        const char* cursor = bytes.data() + sizeof(header);
+        Format::substitute(out, std::string_view(header.format, header.formatSize), sizeof...(Args),
+            [](std::string& o, size_t index, void* context) {
+                const char*& data = *static_cast<const char**>(context);
+                data = kRenderers[index](o, data);
+            }, &cursor);
+    }
+}
+
+} // namespace KL
+
+#endif //! CODEC_H
\ No newline at end of file
@@ -0,0 +1,279 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <array>            // For std::array
+#include <string>           // For std::string
+#include <vector>           // For std::vector
+#include <cstddef>          // For size_t
+#include <chrono>           // For std::chrono::milliseconds
+#include <memory>           // For std::shared_ptr
+
+#include "Level.h"
+
+namespace KL {
+    class WorkerPool;
+
+    /// When the file sink forces written data to stable storage (fdatasync).
+    enum class FsyncPolicy {
+        None,       ///< Never; the OS writes back when it likes
+        Interval,   ///< At most Config::fsyncInterval after data was written
+        Bytes,      ///< Once Config::fsyncBytes have been written since the last sync
+        OnError     ///< After any batch that wrote an ERROR entry to the file
+    };
+
+    /// What a producer does when the queue is full.
+    enum class OverflowPolicy {
+        Block,      ///< Wait (yielding) until the worker frees a slot. Nothing is lost.
+        Drop        ///< Discard the entry and count it (see Logger::dropped_count())
+    };
+
+    /// How the worker thread waits when the queue is empty.
+    enum class WaitStrategy {
+        Block,      ///< Sleep on the condition variable right away (lowest CPU use)
+        Adaptive,   ///< Spin (Config::spinIterations), then yield (Config::yieldIterations), then sleep
+        BusyPoll    ///< Never sleep: poll the queue continuously. Only for a dedicated (pinned) core.
+    };
+
+    /// Scheduling class for the worker thread (Config::workerPolicy).
+    enum class ThreadPolicy {
+        Inherit,    ///< Leave whatever the creating thread had
+        Normal,     ///< SCHED_OTHER; Config::workerPriority is the nice value (-20..19, Linux only)
+        Batch,      ///< SCHED_BATCH (Linux); CPU-bound, fewer preemptions. workerPriority is the nice value
+        Idle,       ///< SCHED_IDLE (Linux); runs only when the CPU has nothing else to do
+        Fifo,       ///< SCHED_FIFO real-time; workerPriority 1..99. Usually needs CAP_SYS_NICE
+        RoundRobin  ///< SCHED_RR real-time; workerPriority 1..99. Usually needs CAP_SYS_NICE
+    };
+
+    /// ANSI colors on the console sink (Config::consoleColor).
+    enum class ColorMode {
+        Auto,       ///< Only where the stream is a terminal, and not when NO_COLOR is set or TERM=dumb
+        Always,     ///< Always, even into pipes and files (overrides NO_COLOR)
+        Never       ///< Never
+    };
+
+    /// Host log protocol of the syslog sink (Config::syslogProtocol).
+    enum class SyslogProtocol {
+        Off,        ///< No syslog sink
+        Rfc5424,    ///< RFC 5424 lines, default socket /dev/log (rsyslog, syslog-ng, journald's syslog socket)
+        Journald    ///< systemd-journald native protocol, default socket /run/systemd/journal/socket
+    };
+
+    /// Per-call-site token bucket for one level (Config::rateLimits).
+    struct RateLimit {
+        double perSecond = 0;   ///< Sustained messages per second per call site; 0 = unlimited
+        size_t burst = 1;       ///< Messages a call site may send back to back before the rate applies
+    };
+
+    /**
+     * @brief Startup options for Logger::init().
+     *
+     * Every field has a default, so callers only set what they need:
+     * @code
+     * KL::Config cfg;
+     * cfg.folderPath = "logs";
+     * cfg.sanitize   = true;
+     * KL::Logger::get_instance().init(cfg);
+     * @endcode
+     */
+    struct Config {
+        /// Directory where log files will be stored. Empty = current working directory.
+        std::string folderPath;
+
+        /// Maximum lines per file before rotation.
+        size_t maxLinesPerFile = 100000;
+
+        /// Log file name prefix: <prefix>_<timestamp>.txt and <prefix>_crash.txt. Give every
+        /// logger instance that shares folderPath its own prefix.
+        std::string filePrefix = "klog";
+
+        /// Escape control characters and invalid UTF-8 in messages before they reach any sink.
+        bool sanitize = false;
+
+        /// Print the call site as [file:line function] for entries logged through the macros.
+        bool showSourceLocation = false;
+
+        /// Print the producing thread as [T<id>] or [T<id>:<name>] (see KL::set_thread_name()).
+        bool showThread = false;
+
+        /// Color console lines by level. Decided once at init, separately for stdout and stderr;
+        /// uncolored lines save the escape codes (about 10 bytes per line) log collectors strip.
+        ColorMode consoleColor = ColorMode::Auto;
+
+        /**
+         * @brief Console lines per second per level, indexed like rateLimits; 0 = no cap.
+         *
+         * Keeps a slow terminal from backing up the logger: lines over the cap in each
+         * one-second window skip the console but still reach the log file (FLOG_), so the file's
+         * throughput no longer depends on the terminal's. LOG_ lines over the cap are only
+         * counted (and kept by the flight recorder, if enabled). After every window that held
+         * lines back the console shows "N INFO lines suppressed on console" (LoggerStats::consoleSuppressed).
+         */
+        std::array<double, kLevelCount> consoleLinesPerSecond{};
+
+        /// Apply consoleLinesPerSecond only to console streams that are terminals; pipes and files get every line.
+        bool consoleThrottleTerminalOnly = true;
+
+        /// Durability of the file sink. Syncs are batched: one fdatasync covers every entry written before it.
+        FsyncPolicy fsyncPolicy = FsyncPolicy::None;
+
+        /// FsyncPolicy::Interval: maximum time written data may stay unsynced.
+        std::chrono::milliseconds fsyncInterval{1000};
+
+        /// FsyncPolicy::Bytes: unsynced bytes that trigger a sync.
+        size_t fsyncBytes = 1024 * 1024;
+
+        /// Slots in the lock-free entry queue (rounded up to a power of two). Allocated once at init.
+        size_t queueCapacity = 8192;
+
+        /// Behaviour when all queueCapacity slots are in use.
+        OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+
+        /// Install the async-signal-safe crash handler that dumps pending entries on SIGSEGV, SIGABRT, ...
+        bool crashHandler = true;
+
+        /// With crashHandler: also write a stack trace (to stderr and the log file) before re-raising.
+        bool crashStackTrace = true;
+
+        /// Entries below this level are discarded on the logging thread; the macros then skip
+        /// evaluating the message altogether. Can be changed later with Logger::set_level().
+        Level minLevel = Level::INFO;
+
+        /// FLOG_ entries below this level are not written to the file (they still reach the console).
+        Level fileLevel = Level::INFO;
+
+        /**
+         * @brief Flight recorder size in entries; 0 disables it.
+         *
+         * When enabled, the worker keeps the most recent entries that did NOT go to the file
+         * (console-only entries and those below fileLevel) in a preallocated in-memory ring.
+         * The ring is written to the file when an entry at or above flightRecorderTrigger
+         * arrives, on Logger::dump_flight_recorder(), and from the crash handler.
+         */
+        size_t flightRecorderEntries = 0;
+
+        /// Bytes reserved per flight recorder entry; longer lines are truncated.
+        size_t flightRecorderEntryBytes = 256;
+
+        /// Level that makes the worker dump the flight recorder to the file.
+        Level flightRecorderTrigger = Level::ERROR;
+
+        /**
+         * @brief POSIX shared-memory segment name (e.g. "/myapp.klog"); empty disables it.
+         *
+         * When set, FLOG_ entries are copied by the logging thread straight into a ring in
+         * this segment (see ShmRing.h for the layout) instead of being written to a file by
+         * this process. Run `kl-collector <name> --prefix <filePrefix>` to drain the ring to disk;
+         * records survive even if this process is killed. A segment of the same name that still
+         * holds undrained records is not replaced (the file sink is used instead). Console output
+         * is unchanged. flush() then covers only the in-process sinks, and the flight recorder is
+         * not used. Not available on Windows.
+         */
+        std::string sharedMemoryName;
+
+        /// Data area of the shared-memory ring in bytes (rounded up to a power of two).
+        size_t sharedMemoryBytes = 4 * 1024 * 1024;
+
+        /**
+         * @brief Also forward entries to the host log over a local Unix datagram socket (see SyslogSink.h).
+         *
+         * Every entry at or above syslogLevel is sent, LOG_ and FLOG_ alike, as its plain message
+         * (the host log adds its own timestamp and metadata). The worker batches the datagrams
+         * with sendmmsg() and never blocks on the socket: what does not fit in the socket buffer
+         * is dropped and counted (LoggerStats::syslogDropped). Not available on Windows.
+         */
+        SyslogProtocol syslogProtocol = SyslogProtocol::Off;
+
+        /// Socket to send to; empty = /dev/log (Rfc5424) or /run/systemd/journal/socket (Journald).
+        std::string syslogSocketPath;
+
+        /// APP-NAME / SYSLOG_IDENTIFIER; empty = the program name.
+        std::string syslogIdentifier;
+
+        /// Syslog facility code: 1 = user, 3 = daemon, 16..23 = local0..local7.
+        int syslogFacility = 1;
+
+        /// Entries below this level are not forwarded to the syslog sink.
+        Level syslogLevel = Level::INFO;
+
+        /**
+         * @brief Worker idle strategy.
+         *
+         * Producers only pay for a wake-up (mutex + futex) when the worker has actually gone to
+         * sleep, so keeping the worker awake a little longer saves that syscall on every
+         * message at moderate rates, at the cost of worker CPU time.
+         */
+        WaitStrategy waitStrategy = WaitStrategy::Adaptive;
+
+        /// WaitStrategy::Adaptive: empty-queue polls with a CPU pause hint before yielding.
+        size_t spinIterations = 1000;
+
+        /// WaitStrategy::Adaptive: empty-queue polls with std::this_thread::yield() before sleeping.
+        size_t yieldIterations = 10;
+
+        /**
+         * @brief CPUs the worker thread may run on; empty = no pinning (Linux, Windows).
+         *
+         * The worker pins itself before it allocates the entry queue and flight recorder, so
+         * on NUMA machines their pages are first touched, and thus placed, on its node.
+         */
+        std::vector<int> workerCpus;
+
+        /// Scheduling class of the worker thread.
+        ThreadPolicy workerPolicy = ThreadPolicy::Inherit;
+
+        /// Real-time priority (ThreadPolicy::Fifo / RoundRobin) or nice value (Normal / Batch) of the worker.
+        int workerPriority = 0;
+
+        /// Worker thread name as shown by top -H / perf / gdb (Linux keeps 15 characters).
+        std::string workerThreadName = "kl-worker";
+
+        /**
+         * @brief Drain this logger on a shared WorkerPool instead of its own worker thread.
+         *
+         * The pool's threads replace the worker, so waitStrategy, the worker* placement options
+         * and the batch scheduler do not apply. The logger keeps the pool alive.
+         */
+        std::shared_ptr<WorkerPool> workerPool;
+
+        /**
+         * @brief Batch scheduler: longest time the worker lets entries accumulate; 0 disables it.
+         *
+         * With a non-zero delay, a worker that wakes up to only a few pending entries goes back
+         * to sleep (producers do not wake it for every message) until batchMinEntries are
+         * pending or this much time has passed, then drains everything in one batch: one write()
+         * per sink and far fewer wake-ups per line, for at most this much added latency.
+         * flush() and shutdown end the wait at once. With OverflowPolicy::Drop, size
+         * queueCapacity for the entries that can arrive during one delay.
+         */
+        std::chrono::microseconds batchMaxDelay{0};
+
+        /// Batch scheduler: pending entries that end the wait early; 0 = only batchMaxDelay (or a full queue) does.
+        size_t batchMinEntries = 0;
+
+        /**
+         * @brief Rate limits for macro call sites, indexed by level:
+         * `cfg.rateLimits[static_cast<size_t>(KL::Level::ERROR)] = {100, 20};`
+         *
+         * Every LOG_ / FLOG_ call site has its own bucket, checked on the logging thread
+         * before the message is built or queued (lock-free, one steady_clock read, so wall
+         * clock steps do not affect it). Rejected messages are never built, only counted:
+         * LoggerStats::rateLimited includes them at once, and the next admitted message from
+         * that site is preceded by a "N messages suppressed" line.
+         */
+        std::array<RateLimit, kLevelCount> rateLimits{};
+
+        /**
+         * @brief Collapse consecutive identical entries (same call site, level, sinks and text)
+         * into one line followed by "last message repeated N times".
+         *
+         * The summary is written when a different entry arrives, on flush() and shutdown, and
+         * at least once per second while the repetition goes on (LoggerStats::repeated).
+         */
+        bool deduplicate = false;
+
+        /// Write a "kLogger stats" line (see Logger::stats()) to the log file this often; 0 disables it.
+        std::chrono::milliseconds metricsInterval{0};
+    };
+}
+
+#endif //! CONFIG_H
\ No newline at end of file
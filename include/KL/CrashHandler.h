@@ -0,0 +1,366 @@
+#ifndef CRASHHANDLER_H
+#define CRASHHANDLER_H
+
+#include <atomic>           // For std::atomic
+#include <csignal>          // For signal numbers, sigaction
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint64_t, int64_t
+#include <new>              // For std::nothrow
+
+#ifdef _WIN32
+    #include <io.h>         // _write
+#else
+    #include <unistd.h>     // write
+    #include <cerrno>       // errno, EINTR
+#endif
+
+namespace KL {
+
+/**
+ * @brief Async-signal-safe building blocks for the crash path.
+ *
+ * Everything reachable from the installed handler uses only write(2), atomics and plain
+ * memory reads: no allocation, no locks, no stdio/iostream. Handlers run on an alternate
+ * signal stack (sigaltstack) so a stack overflow can still be reported, and whatever
+ * handler was installed before is chained to instead of being replaced.
+ */
+namespace Crash {
+
+    /// Size of each thread's alternate signal stack
+    inline constexpr size_t kAltStackSize = 64 * 1024;
+
+    /// write(2) with EINTR / partial-write handling. Async-signal-safe.
+    inline void raw_write(int fd, const char* data, size_t size) noexcept
+    {
+        if (fd < 0) {
+            return;
+        }
+        while (size > 0) {
+            #ifdef _WIN32
+                const int written = _write(fd, data, static_cast<unsigned int>(size));
+            #else
+                const ssize_t written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+            #endif
+            if (written <= 0) {
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    /**
+     * @class SafeWriter
+     * @brief Stack-buffered text writer for signal handlers; flushes with raw_write().
+     */
+    class SafeWriter {
+    public:
+        explicit SafeWriter(int fd) noexcept : mFd(fd) {}
+        ~SafeWriter() { flush(); }
+
+        SafeWriter(const SafeWriter&) = delete;
+        SafeWriter& operator=(const SafeWriter&) = delete;
+
+        void append(const char* data, size_t size) noexcept
+        {
+            while (size > 0) {
+                if (mSize == sizeof(mBuffer)) {
+                    flush();
+                }
+                size_t chunk = sizeof(mBuffer) - mSize;
+                chunk = (chunk < size) ? chunk : size;
+                for (size_t i = 0; i < chunk; ++i) {
+                    mBuffer[mSize + i] = data[i];
+                }
+                mSize += chunk;
+                data += chunk;
+                size -= chunk;
+            }
+        }
+
+        void append(const char* text) noexcept
+        {
+            if (text == nullptr) {
+                return;
+            }
+            size_t length = 0;
+            while (text[length] != '\0') {
+                ++length;
+            }
+            append(text, length);
+        }
+
+        void append_char(char c) noexcept { append(&c, 1); }
+
+        /// Decimal, left-padded with zeros to at least minDigits
+        void append_uint(uint64_t value, int minDigits = 1) noexcept
+        {
+            char digits[24];
+            int count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0 && count < 20);
+            while (count < minDigits && count < 20) {
+                digits[count++] = '0';
+            }
+            while (count > 0) {
+                append_char(digits[--count]);
+            }
+        }
+
+        /// Lower-case hexadecimal with 0x prefix
+        void append_hex(uint64_t value) noexcept
+        {
+            static constexpr char hex[] = "0123456789abcdef";
+            char digits[16];
+            int count = 0;
+            do {
+                digits[count++] = hex[value & 0xF];
+                value >>= 4;
+            } while (value != 0);
+            append("0x", 2);
+            while (count > 0) {
+                append_char(digits[--count]);
+            }
+        }
+
+        /// Same escaping rules as Sanitizer, implemented without std::string
+        void append_escaped(const char* data, size_t size) noexcept
+        {
+            static constexpr char hex[] = "0123456789abcdef";
+            for (size_t i = 0; i < size; ++i) {
+                const auto c = static_cast<unsigned char>(data[i]);
+                if (c >= 0x20 && c != 0x7F) {
+                    append_char(static_cast<char>(c));  // UTF-8 passes through unvalidated here
+                }
+                else if (c == '\n') { append("\\n", 2); }
+                else if (c == '\r') { append("\\r", 2); }
+                else if (c == '\t') { append("\\t", 2); }
+                else {
+                    const char escaped[4] = { '\\', 'x', hex[c >> 4], hex[c & 0x0F] };
+                    append(escaped, sizeof(escaped));
+                }
+            }
+        }
+
+        /**
+         * @brief Appends DD-MM-YYYY HH:MM:SS.mmm (same layout as Logger's timestamps).
+         *
+         * localtime_r() is not async-signal-safe, so the conversion is pure arithmetic on
+         * the epoch time plus a UTC offset captured when the logger was initialized.
+         */
+        void append_timestamp(int64_t epochMillis, int64_t utcOffsetSeconds) noexcept
+        {
+            const int64_t localMillis = epochMillis + utcOffsetSeconds * 1000;
+            int64_t days = localMillis / 86400000;
+            int64_t msOfDay = localMillis % 86400000;
+            if (msOfDay < 0) {
+                msOfDay += 86400000;
+                --days;
+            }
+
+            // days since 1970-01-01 -> civil date (H. Hinnant's algorithm)
+            days += 719468;
+            const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+            const int64_t doe = days - era * 146097;
+            const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const int64_t mp  = (5 * doy + 2) / 153;
+            const int64_t day = doy - (153 * mp + 2) / 5 + 1;
+            const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+            const int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+            append_uint(static_cast<uint64_t>(day), 2);
+            append_char('-');
+            append_uint(static_cast<uint64_t>(month), 2);
+            append_char('-');
+            append_uint(static_cast<uint64_t>(year), 4);
+            append_char(' ');
+            append_uint(static_cast<uint64_t>(msOfDay / 3600000), 2);
+            append_char(':');
+            append_uint(static_cast<uint64_t>(msOfDay / 60000 % 60), 2);
+            append_char(':');
+            append_uint(static_cast<uint64_t>(msOfDay / 1000 % 60), 2);
+            append_char('.');
+            append_uint(static_cast<uint64_t>(msOfDay % 1000), 3);
+        }
+
+        void flush() noexcept
+        {
+            raw_write(mFd, mBuffer, mSize);
+            mSize = 0;
+        }
+
+    private:
+        int mFd;
+        size_t mSize{0};
+        char mBuffer[1024];
+    };
+
+    /// Callback run inside the signal handler; must itself be async-signal-safe
+    using DumpFn = void (*)(int signalNumber);
+
+    namespace detail {
+        #ifdef _WIN32
+            inline constexpr int kSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+        #else
+            inline constexpr int kSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS };
+        #endif
+        inline constexpr size_t kSignalCount = sizeof(kSignals) / sizeof(kSignals[0]);
+
+        inline std::atomic<DumpFn> gDump{nullptr};
+        inline std::atomic<bool> gInstalled{false};
+        inline std::atomic<bool> gInCrash{false};
+
+        #ifdef _WIN32
+            using Previous = void (*)(int);
+            inline Previous gPrevious[kSignalCount]{};
+        #else
+            inline struct sigaction gPrevious[kSignalCount]{};
+        #endif
+
+        inline int signal_index(int signalNumber) noexcept
+        {
+            for (size_t i = 0; i < kSignalCount; ++i) {
+                if (kSignals[i] == signalNumber) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        inline void announce(int signalNumber) noexcept
+        {
+            SafeWriter out(2);
+            out.append("\nProgram crashed (signal ");
+            out.append_uint(static_cast<uint64_t>(signalNumber));
+            out.append(")! Flushing logs...\n");
+        }
+
+        #ifdef _WIN32
+            inline void handle(int signalNumber)
+            {
+                if (!gInCrash.exchange(true)) {
+                    announce(signalNumber);
+                    if (DumpFn dump = gDump.load()) {
+                        dump(signalNumber);
+                    }
+                }
+
+                const int index = signal_index(signalNumber);
+                const Previous previous = (index >= 0) ? gPrevious[index] : SIG_DFL;
+                std::signal(signalNumber, (previous == SIG_ERR) ? SIG_DFL : previous);
+                std::raise(signalNumber);
+            }
+        #else
+            inline void handle(int signalNumber, siginfo_t* info, void* context)
+            {
+                const int index = signal_index(signalNumber);
+
+                // A second fault while dumping: skip straight to the previous disposition
+                if (!gInCrash.exchange(true)) {
+                    announce(signalNumber);
+                    if (DumpFn dump = gDump.load()) {
+                        dump(signalNumber);
+                    }
+                }
+
+                if (index < 0) {
+                    signal(signalNumber, SIG_DFL);
+                    raise(signalNumber);
+                    return;
+                }
+
+                // Chain: restore whatever was installed before us, then hand the signal to it
+                const struct sigaction& previous = gPrevious[index];
+                sigaction(signalNumber, &previous, nullptr);
+
+                if (previous.sa_flags & SA_SIGINFO) {
+                    if (previous.sa_sigaction != nullptr) {
+                        previous.sa_sigaction(signalNumber, info, context);
+                        return;
+                    }
+                }
+                else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+                    previous.sa_handler(signalNumber);
+                    return;
+                }
+
+                // Default action: re-raise (delivered once we return, with the signal unblocked)
+                raise(signalNumber);
+            }
+        #endif
+    }
+
+    /**
+     * @brief Gives the calling thread an alternate signal stack so stack overflows can be handled.
+     *
+     * sigaltstack() is per thread. The logger calls this for the thread that runs init() and
+     * for its worker; other threads that may overflow their stack should call it once at start.
+     * The stack memory is intentionally never freed.
+     *
+     * @return true if the thread has an alternate stack after the call.
+     */
+    inline bool install_alt_stack() noexcept
+    {
+        #ifdef _WIN32
+            return false;
+        #else
+            stack_t current{};
+            if (sigaltstack(nullptr, &current) == 0 && !(current.ss_flags & SS_DISABLE) && current.ss_sp != nullptr) {
+                return true;
+            }
+
+            char* memory = new (std::nothrow) char[kAltStackSize];
+            if (memory == nullptr) {
+                return false;
+            }
+
+            stack_t altStack{};
+            altStack.ss_sp = memory;
+            altStack.ss_size = kAltStackSize;
+            altStack.ss_flags = 0;
+            if (sigaltstack(&altStack, nullptr) != 0) {
+                delete[] memory;
+                return false;
+            }
+            return true;
+        #endif
+    }
+
+    /**
+     * @brief Installs the crash handler for SIGSEGV, SIGABRT, SIGFPE, SIGILL (and SIGBUS).
+     *
+     * The previous disposition of every signal is saved and chained to after the dump.
+     * Only the first call installs handlers; later calls just replace the dump callback.
+     *
+     * @param dump Async-signal-safe function that writes out pending log data.
+     */
+    inline void install_handlers(DumpFn dump) noexcept
+    {
+        detail::gDump.store(dump);
+        if (detail::gInstalled.exchange(true)) {
+            return;
+        }
+
+        for (size_t i = 0; i < detail::kSignalCount; ++i) {
+            #ifdef _WIN32
+                detail::gPrevious[i] = std::signal(detail::kSignals[i], detail::handle);
+            #else
+                struct sigaction action{};
+                action.sa_sigaction = detail::handle;
+                action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+                sigemptyset(&action.sa_mask);
+                sigaction(detail::kSignals[i], &action, &detail::gPrevious[i]);
+            #endif
+        }
+    }
+}
+
+} // namespace KL
+
+#endif //! CRASHHANDLER_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef DEFERREDMESSAGE_H
+#define DEFERREDMESSAGE_H
+
+#include <cstddef>          // For size_t
+#include <new>              // For placement new
+#include <string>           // For std::string
+#include <type_traits>      // For std::is_nothrow_move_constructible_v, std::is_invocable_v
+#include <utility>          // For std::move, std::forward
+
+namespace KL {
+
+/**
+ * @brief A message-producing callable carried through the queue and run by the worker
+ * (Logger::log_deferred(), the *_DEFERRED macros).
+ *
+ * The callable lives inline in the queue slot (kInlineBytes), so deferring it never
+ * allocates; callables that do not fit, or could throw while being moved, are rejected at
+ * compile time through fits<F> and the caller formats on its own thread instead. Whatever
+ * the callable captures must still be valid when the worker gets to it: capture by value.
+ */
+class DeferredMessage {
+public:
+    static constexpr size_t kInlineBytes = 40;
+
+    /// Whether a callable of type F can be stored inline
+    template <typename F>
+    static constexpr bool fits = sizeof(F) <= kInlineBytes
+                              && alignof(F) <= alignof(void*)
+                              && std::is_nothrow_move_constructible_v<F>;
+
+    DeferredMessage() noexcept = default;
+
+    template <typename F, typename Fn = std::decay_t<F>, std::enable_if_t<fits<Fn>, int> = 0>
+    explicit DeferredMessage(F&& make)
+        : mOps(&kOps<Fn>)
+    {
+        new (mStorage) Fn(std::forward<F>(make));
+    }
+
+    DeferredMessage(DeferredMessage&& other) noexcept
+    {
+        take(other);
+    }
+
+    DeferredMessage& operator=(DeferredMessage&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    DeferredMessage(const DeferredMessage&) = delete;
+    DeferredMessage& operator=(const DeferredMessage&) = delete;
+
+    ~DeferredMessage()
+    {
+        reset();
+    }
+
+    /// true while a callable is held
+    explicit operator bool() const noexcept
+    {
+        return mOps != nullptr;
+    }
+
+    /// Runs the callable, stores its result in out and releases the callable
+    void invoke(std::string& out)
+    {
+        if (mOps != nullptr) {
+            mOps->invoke(mStorage, out);
+            reset();
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* self, std::string& out);
+        void (*move)(void* from, void* to) noexcept;
+        void (*destroy)(void* self) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr Ops kOps = {
+        [](void* self, std::string& out) { out = (*static_cast<Fn*>(self))(); },
+        [](void* from, void* to) noexcept { new (to) Fn(std::move(*static_cast<Fn*>(from))); },
+        [](void* self) noexcept { static_cast<Fn*>(self)->~Fn(); },
+    };
+
+    void take(DeferredMessage& other) noexcept
+    {
+        if (other.mOps != nullptr) {
+            other.mOps->move(other.mStorage, mStorage);
+            mOps = other.mOps;
+            other.reset();
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (mOps != nullptr) {
+            mOps->destroy(mStorage);
+            mOps = nullptr;
+        }
+    }
+
+    alignas(void*) unsigned char mStorage[kInlineBytes];
+    const Ops* mOps = nullptr;
+};
+
+/**
+ * @brief The text of a macro's msg argument: the result of calling it if it is a callable,
+ * otherwise the value itself.
+ *
+ * The macros evaluate msg inside a lambda that calls this, so a message is built only once
+ * its line has passed the level check and the call site's rate limit.
+ */
+template <typename T>
+std::string message_of(T&& msg)
+{
+    if constexpr (std::is_invocable_v<T&>) {
+        return std::string(msg());
+    }
+    else {
+        return std::string(std::forward<T>(msg));
+    }
+}
+
+} // namespace KL
+
+#endif //! DEFERREDMESSAGE_H
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <atomic>           // For std::atomic
+#include <memory>           // For std::unique_ptr
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint32_t
+#include <cstring>          // For std::memcpy
+
+namespace KL {
+
+/**
+ * @class FlightRecorder
+ * @brief Fixed-size in-memory ring of the most recent formatted lines that were not written to file.
+ *
+ * All memory (capacity * entryBytes) is allocated once by allocate(); recording a line is a
+ * bounded memcpy that overwrites the oldest slot, so memory use never grows. Lines longer
+ * than a slot are truncated.
+ *
+ * Only the worker thread records and clears. for_each() performs plain reads and may also be
+ * used from the crash handler (best effort if the worker is mid-copy).
+ */
+class FlightRecorder {
+public:
+    FlightRecorder() = default;
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Preallocates the ring. capacity == 0 leaves the recorder disabled.
+     * @param capacity   Number of lines kept
+     * @param entryBytes Maximum bytes stored per line
+     */
+    void allocate(size_t capacity, size_t entryBytes)
+    {
+        if (capacity == 0 || entryBytes == 0) {
+            return;
+        }
+
+        mText.reset(new char[capacity * entryBytes]);
+        mLengths.reset(new uint32_t[capacity]());
+        mCapacity = capacity;
+        mEntryBytes = entryBytes;
+        mRecorded.store(0, std::memory_order_relaxed);
+        mStart = 0;
+    }
+
+    /// True when allocate() was called with a non-zero capacity
+    bool enabled() const noexcept { return mCapacity != 0; }
+
+    /// Lines currently held
+    size_t size() const noexcept
+    {
+        const size_t held = mRecorded.load(std::memory_order_acquire) - mStart;
+        return (held < mCapacity) ? held : mCapacity;
+    }
+
+    /// Stores a copy of line (truncated to entryBytes), replacing the oldest line when full
+    void record(const char* line, size_t length) noexcept
+    {
+        const size_t recorded = mRecorded.load(std::memory_order_relaxed);
+        const size_t index = recorded % mCapacity;
+        const size_t stored = (length < mEntryBytes) ? length : mEntryBytes;
+
+        std::memcpy(mText.get() + index * mEntryBytes, line, stored);
+        mLengths[index] = static_cast<uint32_t>(stored);
+        mRecorded.store(recorded + 1, std::memory_order_release);
+    }
+
+    /// Visits held lines oldest first as (data, length). No allocation, no locks.
+    template <typename Fn>
+    void for_each(Fn&& fn) const noexcept
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        const size_t recorded = mRecorded.load(std::memory_order_acquire);
+        const size_t held = size();
+        for (size_t i = recorded - held; i != recorded; ++i) {
+            const size_t index = i % mCapacity;
+            fn(mText.get() + index * mEntryBytes, static_cast<size_t>(mLengths[index]));
+        }
+    }
+
+    /// Forgets all held lines (after they were dumped)
+    void clear() noexcept
+    {
+        mStart = mRecorded.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<char[]> mText;
+    std::unique_ptr<uint32_t[]> mLengths;
+    size_t mCapacity{0};
+    size_t mEntryBytes{0};
+    std::atomic<size_t> mRecorded{0};   // Total lines ever recorded
+    size_t mStart{0};                   // mRecorded value at the last clear()
+};
+
+} // namespace KL
+
+#endif //! FLIGHTRECORDER_H
\ No newline at end of file
@@ -0,0 +1,331 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint64_t, uintptr_t
+#include <cstdio>           // For std::snprintf (floating point fallback)
+#include <cstdlib>          // For std::strtod (floating point fallback)
+#include <string>           // For std::string
+#include <string_view>      // For std::string_view
+#include <type_traits>      // For type dispatch
+#include <utility>          // For std::declval
+
+#if defined(__has_include)
+    #if __has_include(<charconv>)
+        #include <charconv>     // For std::to_chars
+    #endif
+#endif
+
+namespace KL {
+
+/**
+ * @brief Message formatting without iostream or std::to_string.
+ *
+ * format("{} of {} done in {} ms", n, total, ms) substitutes each "{}" with the next argument;
+ * "{{" and "}}" are literal braces. A "{}" with no argument left is copied as-is and surplus
+ * arguments are ignored, so a wrong count shows up in the line instead of throwing.
+ *
+ * Supported arguments:
+ *   - bool ("true"/"false"), char
+ *   - integers and enums: two digits per step from a 200-byte pair table
+ *   - float / double: shortest text that reads back to the same value (std::to_chars when the
+ *     standard library has it, otherwise the shorter of %.15g / %.17g that round-trips)
+ *   - const char*, char arrays, std::string, std::string_view
+ *   - pointers: 0x-prefixed hex; hex(value) for integers in hex
+ *   - any type with a KL::Formatter specialization
+ *
+ * Everything appends to a caller-owned std::string, which the Logger reuses, so formatting
+ * allocates at most once per message.
+ */
+/**
+ * @brief Customization point for user types in KL::format and the LOGF_* macros.
+ *
+ * Specialize with `static void format(std::string& out, const T& value)` appending the text:
+ *
+ *     template <> struct KL::Formatter<Order> {
+ *         static void format(std::string& out, const Order& o) { KL::format_to(out, "#{} x{}", o.id, o.qty); }
+ *     };
+ *
+ * A trivially copyable type needs nothing else to be formatted on the worker by the
+ * LOGF_*_DEFERRED macros (see KL::Codec).
+ */
+template <typename T, typename Enable = void>
+struct Formatter {};
+
+namespace Format {
+
+    /// Integer printed as lowercase hex without prefix (see hex())
+    struct Hex {
+        uint64_t value;
+    };
+
+    namespace detail {
+        inline constexpr char kDigitPairs[201] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        inline constexpr size_t kMaxIntegerChars = 20;    // UINT64_MAX
+        inline constexpr size_t kMaxFloatChars = 32;      // -1.7976931348623157e+308
+
+        template <typename T>
+        inline constexpr bool kIsChar = std::is_same_v<T, char> || std::is_same_v<T, signed char>
+                                     || std::is_same_v<T, unsigned char>;
+
+        template <typename T, typename = void>
+        struct HasFormatter : std::false_type {};
+
+        template <typename T>
+        struct HasFormatter<T, std::void_t<decltype(Formatter<T>::format(std::declval<std::string&>(), std::declval<const T&>()))>>
+            : std::true_type {};
+    }
+
+    /// Whether KL::Formatter<T> is specialized
+    template <typename T>
+    inline constexpr bool kHasFormatter = detail::HasFormatter<T>::value;
+
+    /**
+     * @brief Writes value right-aligned so that it ends at end; returns where it starts.
+     * The buffer before end must hold kMaxIntegerChars bytes.
+     */
+    inline char* write_uint_backward(char* end, uint64_t value) noexcept
+    {
+        char* out = end;
+        while (value >= 100) {
+            const size_t pair = static_cast<size_t>(value % 100) * 2;
+            value /= 100;
+            out -= 2;
+            out[0] = detail::kDigitPairs[pair];
+            out[1] = detail::kDigitPairs[pair + 1];
+        }
+        if (value >= 10) {
+            const size_t pair = static_cast<size_t>(value) * 2;
+            out -= 2;
+            out[0] = detail::kDigitPairs[pair];
+            out[1] = detail::kDigitPairs[pair + 1];
+        }
+        else {
+            *--out = static_cast<char>('0' + value);
+        }
+        return out;
+    }
+
+    /// Writes exactly two digits (value < 100), as used for timestamps
+    inline char* write_2digits(char* out, unsigned value) noexcept
+    {
+        out[0] = detail::kDigitPairs[value * 2];
+        out[1] = detail::kDigitPairs[value * 2 + 1];
+        return out + 2;
+    }
+
+    /// Appends an unsigned decimal integer
+    inline void append_uint(std::string& out, uint64_t value)
+    {
+        char buffer[detail::kMaxIntegerChars];
+        char* const end = buffer + sizeof(buffer);
+        const char* begin = write_uint_backward(end, value);
+        out.append(begin, static_cast<size_t>(end - begin));
+    }
+
+    /// Appends a signed decimal integer
+    inline void append_int(std::string& out, int64_t value)
+    {
+        char buffer[detail::kMaxIntegerChars + 1];
+        char* const end = buffer + sizeof(buffer);
+        // Negate in unsigned arithmetic so INT64_MIN does not overflow
+        const uint64_t magnitude = (value < 0) ? (0 - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+        char* begin = write_uint_backward(end, magnitude);
+        if (value < 0) {
+            *--begin = '-';
+        }
+        out.append(begin, static_cast<size_t>(end - begin));
+    }
+
+    /// Appends lowercase hex digits (no prefix, no leading zeros)
+    inline void append_hex(std::string& out, uint64_t value)
+    {
+        static constexpr char kHexDigits[] = "0123456789abcdef";
+        char buffer[16];
+        char* const end = buffer + sizeof(buffer);
+        char* begin = end;
+        do {
+            *--begin = kHexDigits[value & 0xF];
+            value >>= 4;
+        } while (value != 0);
+        out.append(begin, static_cast<size_t>(end - begin));
+    }
+
+    /// Appends the shortest decimal text that parses back to value ("inf", "nan" for non-finite)
+    inline void append_double(std::string& out, double value)
+    {
+        char buffer[detail::kMaxFloatChars];
+        #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+        #else
+            int length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+            if (std::strtod(buffer, nullptr) != value && value == value) {
+                length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            }
+            out.append(buffer, static_cast<size_t>(length));
+        #endif
+    }
+
+    /// float variant: shortest text for the float, not for its double widening
+    inline void append_float(std::string& out, float value)
+    {
+        #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            char buffer[detail::kMaxFloatChars];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+        #else
+            char buffer[detail::kMaxFloatChars];
+            int length = std::snprintf(buffer, sizeof(buffer), "%.6g", static_cast<double>(value));
+            if (std::strtof(buffer, nullptr) != value && value == value) {
+                length = std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(value));
+            }
+            out.append(buffer, static_cast<size_t>(length));
+        #endif
+    }
+
+    /// Appends a pointer as 0x-prefixed hex
+    inline void append_pointer(std::string& out, const void* pointer)
+    {
+        out += "0x";
+        append_hex(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)));
+    }
+
+    /// Appends one argument according to its type (see the namespace comment for the list)
+    template <typename T>
+    void append(std::string& out, const T& value)
+    {
+        if constexpr (kHasFormatter<T>) {
+            Formatter<T>::format(out, value);
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            out += value ? "true" : "false";
+        }
+        else if constexpr (detail::kIsChar<T>) {
+            out += static_cast<char>(value);
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            append_int(out, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            append_uint(out, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            append(out, static_cast<std::underlying_type_t<T>>(value));
+        }
+        else if constexpr (std::is_same_v<T, float>) {
+            append_float(out, value);
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            append_double(out, static_cast<double>(value));
+        }
+        else if constexpr (std::is_same_v<T, Hex>) {
+            append_hex(out, value.value);
+        }
+        else if constexpr (std::is_convertible_v<const T&, const char*>) {
+            // Character arrays and C strings
+            const char* text = value;
+            out += (text != nullptr) ? text : "(null)";
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            out += std::string_view(value);
+        }
+        else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+            append_pointer(out, static_cast<const void*>(value));
+        }
+        else {
+            static_assert(sizeof(T) == 0, "KL::Format: no formatting for this argument type");
+        }
+    }
+
+    /**
+     * @brief Copies fmt to out, calling appendArg(out, index, context) for each "{}" while
+     * index < argCount (the placeholder scan shared by format_to() and KL::Codec).
+     */
+    inline void substitute(std::string& out, std::string_view fmt, size_t argCount,
+                           void (*appendArg)(std::string& out, size_t index, void* context), void* context)
+    {
+        size_t next = 0;
+        size_t literalStart = 0;
+        for (size_t i = 0; i < fmt.size(); ++i) {
+            const char c = fmt[i];
+            if ((c != '{' && c != '}') || i + 1 >= fmt.size()) {
+                continue;
+            }
+            const char following = fmt[i + 1];
+            if (c == following) {
+                // "{{" or "}}": emit one brace
+                out.append(fmt.data() + literalStart, i + 1 - literalStart);
+                literalStart = i + 2;
+                ++i;
+            }
+            else if (c == '{' && following == '}' && next < argCount) {
+                out.append(fmt.data() + literalStart, i - literalStart);
+                appendArg(out, next, context);
+                ++next;
+                literalStart = i + 2;
+                ++i;
+            }
+        }
+        out.append(fmt.data() + literalStart, fmt.size() - literalStart);
+    }
+
+    /**
+     * @brief Appends fmt to out with every "{}" replaced by the next argument.
+     *
+     * The arguments are reduced to an array of (function, pointer) pairs first, so the
+     * placeholder scan is a single non-template loop whatever the argument types.
+     */
+    template <typename... Args>
+    void format_to(std::string& out, std::string_view fmt, const Args&... args)
+    {
+        struct Arg {
+            void (*append)(std::string&, const void*);
+            const void* value;
+        };
+        Arg list[sizeof...(Args) + 1] = {
+            {[](std::string& o, const void* v) { append(o, *static_cast<const Args*>(v)); }, &args}...,
+            {nullptr, nullptr}
+        };
+
+        substitute(out, fmt, sizeof...(Args), [](std::string& o, size_t index, void* context) {
+            const Arg& arg = static_cast<const Arg*>(context)[index];
+            arg.append(o, arg.value);
+        }, list);
+    }
+
+    /// format_to() into a new string
+    template <typename... Args>
+    std::string format(std::string_view fmt, const Args&... args)
+    {
+        std::string out;
+        out.reserve(fmt.size() + sizeof...(Args) * 8);
+        format_to(out, fmt, args...);
+        return out;
+    }
+}
+
+/// Marks an integer for hex output in KL::format / LOGF_*: format("{}", hex(0xff)) -> "ff"
+template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+constexpr Format::Hex hex(T value) noexcept
+{
+    return Format::Hex{static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value))};
+}
+
+using Format::format;
+using Format::format_to;
+
+} // namespace KL
+
+#endif //! FORMAT_H
\ No newline at end of file
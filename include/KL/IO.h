@@ -0,0 +1,169 @@
+#ifndef IO_H
+#define IO_H
+
+#include <cstddef>          // For size_t, std::ptrdiff_t
+#include <cerrno>           // For errno, EINTR
+#include <filesystem>       // For std::filesystem::path
+
+#ifdef _WIN32
+    #include <io.h>         // _wopen, _write, _commit, _close, _isatty
+    #include <fcntl.h>      // _O_* flags
+    #include <sys/stat.h>   // _S_IREAD, _S_IWRITE
+#else
+    #include <fcntl.h>      // open, O_* flags
+    #include <unistd.h>     // write, fsync, fdatasync, close, isatty
+#endif
+
+namespace KL {
+
+/**
+ * @brief Thin wrappers over the raw file descriptor calls used by the file and console sinks.
+ *
+ * The sinks talk to descriptors directly (instead of std::ofstream / std::cout) so they can
+ * group entries into one write() per batch and make them durable with fdatasync().
+ *
+ * Every call goes through a replaceable Backend table, so tests and audit tools can count or
+ * fake the system calls (see set_backend()). The default backend calls the OS directly.
+ */
+namespace IO {
+
+    /// The system calls behind the IO wrappers. Every function must be async-signal-safe.
+    struct Backend {
+        int (*open_append)(const char* path) noexcept;                          ///< Returns fd or -1
+        std::ptrdiff_t (*write)(int fd, const char* data, size_t size) noexcept; ///< Bytes written or -1 (errno set)
+        bool (*sync_data)(int fd) noexcept;                                     ///< fdatasync() or equivalent
+        void (*close)(int fd) noexcept;
+    };
+
+    namespace detail {
+        inline int system_open_append(const char* path) noexcept
+        {
+            #ifdef _WIN32
+                return _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+            #else
+                int fd = -1;
+                do {
+                    fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+                } while (fd < 0 && errno == EINTR);
+                return fd;
+            #endif
+        }
+
+        inline std::ptrdiff_t system_write(int fd, const char* data, size_t size) noexcept
+        {
+            #ifdef _WIN32
+                const unsigned int chunk = (size > 0x40000000u) ? 0x40000000u : static_cast<unsigned int>(size);
+                return _write(fd, data, chunk);
+            #else
+                return ::write(fd, data, size);
+            #endif
+        }
+
+        inline bool system_sync_data(int fd) noexcept
+        {
+            #if defined(_WIN32)
+                return _commit(fd) == 0;
+            #elif defined(__APPLE__)
+                return ::fsync(fd) == 0;
+            #else
+                return ::fdatasync(fd) == 0;
+            #endif
+        }
+
+        inline void system_close(int fd) noexcept
+        {
+            #ifdef _WIN32
+                _close(fd);
+            #else
+                ::close(fd);
+            #endif
+        }
+    }
+
+    /// Backend that calls the operating system
+    inline constexpr Backend system_backend() noexcept
+    {
+        return Backend{&detail::system_open_append, &detail::system_write, &detail::system_sync_data, &detail::system_close};
+    }
+
+    namespace detail {
+        /// Constant-initialized (no guard variable), so the crash handler may read it
+        inline Backend gBackend = system_backend();
+    }
+
+    /**
+     * @brief Replaces the backend used by every IO call and returns the previous one.
+     *
+     * Install it before Logger::init() (and restore it after shutdown); swapping while the
+     * worker is writing is not synchronized.
+     */
+    inline Backend set_backend(const Backend& backend) noexcept
+    {
+        const Backend previous = detail::gBackend;
+        detail::gBackend = backend;
+        return previous;
+    }
+
+    /// Opens (creating if needed) a file for appending. Returns -1 on failure. Async-signal-safe.
+    inline int open_append(const char* path) noexcept
+    {
+        return detail::gBackend.open_append(path);
+    }
+
+    /// Opens (creating if needed) a file for appending. Returns -1 on failure.
+    inline int open_append(const std::filesystem::path& path) noexcept
+    {
+        #ifdef _WIN32
+            // Wide path: bypasses the backend, which takes narrow paths
+            return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+        #else
+            return open_append(path.c_str());
+        #endif
+    }
+
+    /// Writes the whole buffer, retrying on partial writes and EINTR. Returns false on error.
+    inline bool write_all(int fd, const char* data, size_t size) noexcept
+    {
+        while (size > 0) {
+            const std::ptrdiff_t written = detail::gBackend.write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    /// Flushes file data (not necessarily metadata) to stable storage. Returns false on error.
+    inline bool sync_data(int fd) noexcept
+    {
+        return detail::gBackend.sync_data(fd);
+    }
+
+    /// Whether fd refers to a terminal (not part of the Backend: only asked once, at init)
+    inline bool is_terminal(int fd) noexcept
+    {
+        #ifdef _WIN32
+            return _isatty(fd) != 0;
+        #else
+            return ::isatty(fd) == 1;
+        #endif
+    }
+
+    /// Closes a descriptor; -1 is ignored
+    inline void close(int fd) noexcept
+    {
+        if (fd < 0) {
+            return;
+        }
+        detail::gBackend.close(fd);
+    }
+}
+
+} // namespace KL
+
+#endif //! IO_H
\ No newline at end of file
@@ -1,12 +1,28 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
+#include <cstddef>          // For size_t
+
 namespace KL {
     enum class Level {
         INFO,
         WARNING,
         ERROR
     };
+
+    /// Number of levels, for tables indexed by static_cast<size_t>(level)
+    inline constexpr size_t kLevelCount = 3;
+
+    /// Name of a level as printed in log lines ("INFO", "WARNING", "ERROR")
+    constexpr const char* level_name(Level level) noexcept
+    {
+        switch (level) {
+            case Level::INFO:    return "INFO";
+            case Level::WARNING: return "WARNING";
+            case Level::ERROR:   return "ERROR";
+            default:             return "UNKNOWN";
+        }
+    }
 }
 
 #endif //! LEVEL_H
\ No newline at end of file
@@ -3,15 +3,34 @@
 
 #include <string>           // For std::string
 #include <chrono>           // For std::chrono::syttem_clock::time_point
+#include <cstdint>          // For uint32_t, uint64_t
 
 #include "Level.h"
+#include "SourceSite.h"
+#include "DeferredMessage.h"
+#include "Codec.h"
 
 namespace KL {
+    /// Control markers travelling through the queue in order with the messages
+    enum class Command : uint8_t {
+        None,               // A regular log message
+        Flush,              // flush() barrier; see flushTicket
+        DumpFlightRecorder  // dump_flight_recorder()
+    };
+
     struct LogEntry {
         bool writeToFile;
         std::chrono::system_clock::time_point timeStamp;
         Level level;
         std::string msg;
+        const SourceSite* site = nullptr;   // Call site metadata (nullptr when logged without a macro)
+        uint32_t threadId = 0;              // Producer's ThreadInfo::current_id()
+        uint32_t suppressed = 0;            // Messages the call site's rate limiter rejected just before this one
+        uint32_t sampleRate = 0;            // *_SAMPLED macros: this entry stands for sampleRate entries (0 = not sampled)
+        DeferredMessage deferred{};         // Set: msg is produced by the worker (Logger::log_deferred())
+        EncodedRenderer render = nullptr;   // Set: msg holds argument bytes the worker renders (Logger::log_encoded())
+        Command command = Command::None;    // Anything but None: a marker, not a message
+        uint64_t flushTicket = 0;           // Command::Flush: ticket to complete
     };
 }
 
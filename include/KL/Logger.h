@@ -2,19 +2,23 @@
 #define LOGGER_H
 
 #include <iostream>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <ctime>
-#include <fstream>
 #include <filesystem>
 #include <thread>
 #include <mutex>
-#include <queue>
 #include <condition_variable>
+#include <future>
 #include <atomic>
+#include <exception>
+#include <type_traits>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <cerrno>
 #include <csignal>
 
 #ifdef _WIN32
@@ -22,33 +26,50 @@
         #define WIN32_LEAN_AND_MEAN
     #endif
     #include <windows.h>
-    #include <io.h>  // _write için
-#else
-    #include <unistd.h>  // write, STDOUT_FILENO için
+    #include <intrin.h>     // _mm_pause
 #endif
 
-// TODO: Fix Signal Handler Undefined Behaviour
-// TODO: Fix Atomic/Mutex Data Race
-
 // Project-specific headers
 #include "Level.h"
 #include "LogEntry.h"
 #include "Color.h"
+#include "Config.h"
+#include "Sanitizer.h"
+#include "ThreadInfo.h"
+#include "ThreadPlacement.h"
+#include "IO.h"
+#include "Metrics.h"
+#include "Format.h"
+#include "RingQueue.h"
+#include "CrashHandler.h"
+#include "StackTrace.h"
+#include "FlightRecorder.h"
+#include "ShmRing.h"
+#include "SyslogSink.h"
+#include "RateLimiter.h"
+#include "Sampling.h"
+#include "WorkerPool.h"
 
 namespace KL {
 
 /**
  * @class Logger
- * @brief High-performance, thread-safe, asynchronous logging system using the Singleton pattern.
+ * @brief High-performance, thread-safe, asynchronous logger.
  *
  * This logger writes colored output to the console and rotates log files based on line count.
- * It follows a producer-consumer model: application threads push log entries into a lock-free-style
- * queue while a dedicated background thread consumes them. This design ensures zero blocking on I/O.
+ * It follows a producer-consumer model: application threads push log entries into a bounded lock-free
+ * ring (RingQueue) while a dedicated background thread consumes them. This design ensures zero blocking on I/O.
+ *
+ * get_instance() is the process-wide default used by the LOG_ / FLOG_ macros. Further instances
+ * can be constructed directly or through KL::Registry (see Registry.h); each one has its own
+ * queue, worker thread, sinks and Config, so a noisy component cannot throttle the others.
+ * Instances that share a folderPath need distinct Config::filePrefix values, and many
+ * instances can share the threads of a WorkerPool (Config::workerPool).
  *
  * @note Fully compatible with C++17 (no C++20 features used).
  * @note Zero dynamic allocations in the hot path (timestamp formatting uses stack buffer).
  */
-class Logger {
+class Logger : private PoolClient {
 public:
     /**
      * @brief Returns the singleton instance (Meyers' Singleton - thread-safe since C++11).
@@ -59,6 +80,30 @@ public:
         return instance;
     }
 
+    /// Creates an idle logger; it starts on init() or, with default settings, on its first log()
+    Logger()
+        : mCurrentLineCount(0)
+        , mMaxLines(100000)
+        , mIsRunning(false)
+    {}
+
+    /// Creates a logger and starts it with the given Config
+    explicit Logger(const Config& config)
+        : Logger()
+    {
+        init(config);
+    }
+
+    /// Flushes everything queued and stops the worker thread
+    ~Logger()
+    {
+        shut_down();
+
+        if (mCrashSlot >= 0) {
+            sCrashLoggers[mCrashSlot].store(nullptr);
+        }
+    }
+
     // Delete copy constructor and assignment operator
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
@@ -73,21 +118,78 @@ public:
      */
     void init(const std::string& folderPath = "", size_t maxLinesPerFile = 100000)
     {
-        
-        std::call_once(mInitFlag, [this, folderPath, maxLinesPerFile](){
-            mMaxLines = maxLinesPerFile;
+        Config config;
+        config.folderPath = folderPath;
+        config.maxLinesPerFile = maxLinesPerFile;
+        init(config);
+    }
+
+    /**
+     * @brief Initializes the logger from a full Config and starts the background worker thread.
+     *
+     * Only the first call has any effect; later calls (including the implicit one in log()) are no-ops.
+     *
+     * @param config Startup options (see Config.h).
+     */
+    void init(const Config& config)
+    {
+        std::call_once(mInitFlag, [this, &config](){
+            mMaxLines = config.maxLinesPerFile;
+            mSanitize = config.sanitize;
+            mShowSourceLocation = config.showSourceLocation;
+            mShowThread = config.showThread;
+            mColorStdout = use_color(config.consoleColor, kStdoutFd);
+            mColorStderr = use_color(config.consoleColor, kStderrFd);
+            for (size_t i = 0; i < kLevelCount; ++i) {
+                const double perSecond = config.consoleLinesPerSecond[i];
+                const int fd = (static_cast<Level>(i) == Level::ERROR) ? kStderrFd : kStdoutFd;
+                if (perSecond > 0 && (!config.consoleThrottleTerminalOnly || IO::is_terminal(fd))) {
+                    mConsoleCaps[i].linesPerWindow = std::max<uint64_t>(1, static_cast<uint64_t>(perSecond));
+                    mConsoleThrottled = true;
+                }
+            }
+            mFsyncPolicy = config.fsyncPolicy;
+            mFsyncInterval = config.fsyncInterval;
+            mFsyncBytes = config.fsyncBytes;
+            mOverflowPolicy = config.overflowPolicy;
+            mCrashStackTrace = config.crashStackTrace;
+            mFileLevel = config.fileLevel;
+            mFlightRecorderTrigger = config.flightRecorderTrigger;
+            mMetricsInterval = config.metricsInterval;
+            mWaitStrategy = config.waitStrategy;
+            mSpinIterations = config.spinIterations;
+            mYieldIterations = config.yieldIterations;
+            mDeduplicate = config.deduplicate;
+            mMinLevel.store(config.minLevel, std::memory_order_relaxed);
+            for (size_t i = 0; i < kLevelCount; ++i) {
+                const RateLimit& limit = config.rateLimits[i];
+                if (limit.perSecond > 0) {
+                    mRateLimits[i].intervalNanos = std::max<int64_t>(1, static_cast<int64_t>(1e9 / limit.perSecond));
+                    mRateLimits[i].toleranceNanos = mRateLimits[i].intervalNanos * static_cast<int64_t>(limit.burst > 0 ? limit.burst - 1 : 0);
+                }
+            }
+            if (!config.sharedMemoryName.empty()) {
+                open_shared_memory(config);
+            }
+            if (config.syslogProtocol != SyslogProtocol::Off) {
+                open_syslog(config);
+            }
+            mUtcOffsetSeconds = local_utc_offset();
+            mBatchMaxDelay = config.batchMaxDelay;
+            // Set before the worker starts or the pool attaches: both read it without a lock
+            const size_t queueSlots = RingQueue<LogEntry>::rounded_capacity(config.queueCapacity);
+            mBatchMinEntries = (config.batchMinEntries == 0 || config.batchMinEntries > queueSlots)
+                ? queueSlots : config.batchMinEntries;
 
             // Resolve log directory
             std::error_code ec;
-            mLogDirectory = folderPath.empty() ? std::filesystem::current_path() : std::filesystem::path(folderPath);
+            mLogDirectory = config.folderPath.empty() ? std::filesystem::current_path() : std::filesystem::path(config.folderPath);
             std::filesystem::create_directories(mLogDirectory, ec);
             if (ec) {
                 std::cerr << "[Logger] Failed to create log directory: " << ec.message() << std::endl;
             }
-
-            // Performance: disable stream synchronization with C stdio
-            std::ios::sync_with_stdio(false);
-            std::cout.tie(nullptr);
+            mFilePrefix = config.filePrefix.empty() ? std::string("klog") : config.filePrefix;
+            mCrashPath = (mLogDirectory / (mFilePrefix + "_crash.txt")).string();
 
             #ifdef _WIN32
                 // Enable ANSI color support on Windows 10+ consoles
@@ -102,10 +204,36 @@ public:
                 enableVT();
             #endif
 
-            setup_signal_handlers();
+            if (config.crashHandler) {
+                setup_signal_handlers();
+            }
 
             mIsRunning = true;
-            mWorkerThread = std::thread(&Logger::process_queue, this);
+            mLastMetricsReport = std::chrono::steady_clock::now();
+
+            if (config.workerPool) {
+                // Pool threads drain this logger; the buffers are allocated here instead
+                if (mBatchMaxDelay.count() > 0) {
+                    std::cerr << "[Logger] batchMaxDelay is ignored when workerPool is set" << std::endl;
+                    mBatchMaxDelay = std::chrono::microseconds::zero();
+                }
+                allocate_worker_buffers(config);
+                mPoolOwner = config.workerPool;
+                mPool = mPoolOwner.get();
+                mPool->attach(*this, mFsyncPolicy == FsyncPolicy::Interval || mMetricsInterval.count() > 0 || mDeduplicate || mConsoleThrottled);
+            }
+            else {
+                // The worker places itself and allocates its buffers; nothing may be queued before that
+                std::promise<void> placed;
+                mWorkerThread = std::thread([this, &config, &placed]() {
+                    place_worker(config);
+                    placed.set_value();
+                    process_queue();
+                });
+                placed.get_future().wait();
+            }
+
+            mInitialized.store(true, std::memory_order_release);
         });        
     }
 
@@ -121,263 +249,1741 @@ public:
      */
     void log(Level level, std::string msg, bool writeToFile = true)
     {
+        enqueue(LogEntry{writeToFile, std::chrono::system_clock::now(), level, std::move(msg)});
+    }
 
-        init();
+    /**
+     * @brief Queues a log message tagged with its call site (used by the LOG_ / FLOG_ macros).
+     *
+     * Only the address of the static SourceSite is stored in the entry.
+     *
+     * @param site        Static call site record; must outlive the logger
+     * @param msg         Log message (moved into the queue)
+     * @param writeToFile Whether to write this entry to file (default: true)
+     */
+    void log(const SourceSite& site, std::string msg, bool writeToFile = true)
+    {
+        enqueue(LogEntry{writeToFile, std::chrono::system_clock::now(), site.level, std::move(msg), &site});
+    }
 
-        auto now = std::chrono::system_clock::now();
+    /**
+     * @brief As above, subject to the call site's rate limit (Config::rateLimits).
+     *
+     * A rejected message is only counted in limiter; nothing is queued. The timestamp taken
+     * for the entry doubles as the limiter's clock.
+     *
+     * @param limiter    Static per-call-site limiter state; must outlive the logger
+     * @param sampleRate Set by the *_SAMPLED macros: the line is kept 1 in sampleRate times
+     *                   and printed with a [sampled 1/N] field
+     */
+    void log(const SourceSite& site, RateLimiter& limiter, std::string msg, bool writeToFile = true, uint32_t sampleRate = 0)
+    {
+        submit(site, limiter, writeToFile, sampleRate, [&msg](LogEntry& entry) {
+            entry.msg = std::move(msg);
+        });
+    }
 
-        {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mLogEntryQueue.emplace(LogEntry{writeToFile, now, level, std::move(msg)});
+    /**
+     * @brief Queues format(fmt, args...) (see Format.h); nothing is formatted when the level
+     * is disabled.
+     *
+     * @param fmt  Text with a "{}" per argument
+     * @param args Integers, floats, bool, pointers, strings, hex(value)
+     */
+    template <typename... Args>
+    void logf(Level level, std::string_view fmt, const Args&... args)
+    {
+        if (is_enabled(level)) {
+            log(level, Format::format(fmt, args...));
         }
+    }
 
-        mCV.notify_one();
+    /**
+     * @brief Queues the message returned by make(), which runs on this thread and only if the
+     * level is enabled (see set_level()).
+     */
+    template <typename MakeMessage, std::enable_if_t<std::is_invocable_r_v<std::string, MakeMessage&>, int> = 0>
+    void log(Level level, MakeMessage&& make, bool writeToFile = true)
+    {
+        if (is_enabled(level)) {
+            log(level, std::string(make()), writeToFile);
+        }
+    }
+
+    /// Call-site variant of the callable overload above (rate limit and sampling as for a message)
+    template <typename MakeMessage, std::enable_if_t<std::is_invocable_r_v<std::string, MakeMessage&>, int> = 0>
+    void log(const SourceSite& site, RateLimiter& limiter, MakeMessage&& make, bool writeToFile = true, uint32_t sampleRate = 0)
+    {
+        if (!is_enabled(site.level)) {
+            return;
+        }
+        submit(site, limiter, writeToFile, sampleRate, [&make](LogEntry& entry) {
+            entry.msg = make();
+        });
     }
 
     /**
-     * @brief Forces immediate flush of all queued logs and shuts down the worker thread.
+     * @brief Like the callable overload, but make() runs on the worker thread, right before
+     * the line is formatted (the *_DEFERRED macros).
      *
-     * Called automatically from destructor, but can be called manually before program exit
-     * if strict ordering or immediate flush is required.
+     * The callable is moved into the queue slot without allocating (see DeferredMessage), so
+     * everything it captures must be captured by value and stay valid after this call
+     * returns. Callables too large for the slot, or not nothrow-movable, run here instead,
+     * as does every callable while the file copy goes to shared memory.
      */
-    void flush_and_shutdown()
+    template <typename MakeMessage, std::enable_if_t<std::is_invocable_r_v<std::string, MakeMessage&>, int> = 0>
+    void log_deferred(const SourceSite& site, RateLimiter& limiter, MakeMessage&& make, bool writeToFile = true)
     {
-        shut_down();
+        if (!is_enabled(site.level)) {
+            return;
+        }
+        submit(site, limiter, writeToFile, 0, [this, &make](LogEntry& entry) {
+            if constexpr (DeferredMessage::fits<std::decay_t<MakeMessage>>) {
+                if (!shared_memory_sink_open()) {
+                    entry.deferred = DeferredMessage(std::forward<MakeMessage>(make));
+                    return;
+                }
+            }
+            entry.msg = make();
+        });
     }
 
-private:
-    /// Private constructor - initializes member variables
-    Logger()
-        : mCurrentLineCount(0)
-        , mMaxLines(100000)
-        , mIsRunning(false)
-    {}
+    /**
+     * @brief format(fmt, args...) with the formatting done on the worker (LOGF_*_DEFERRED).
+     *
+     * The arguments are serialized into the entry through KL::Codec: their bytes for trivially
+     * copyable types, a copy for text. fmt is kept by address and must outlive the logger
+     * (a string literal). While the file copy goes to shared memory the text is rendered here.
+     */
+    template <typename... Args>
+    void log_encoded(const SourceSite& site, RateLimiter& limiter, bool writeToFile, std::string_view fmt, const Args&... args)
+    {
+        if (!is_enabled(site.level)) {
+            return;
+        }
+        submit(site, limiter, writeToFile, 0, [&](LogEntry& entry) {
+            if (!shared_memory_sink_open()) {
+                Encoding::encode(entry.msg, fmt, args...);
+                entry.render = &Encoding::render<Encoding::Argument<Args>...>;
+                return;
+            }
+            std::string bytes;
+            Encoding::encode(bytes, fmt, args...);
+            Encoding::render<Encoding::Argument<Args>...>(entry.msg, bytes);
+        });
+    }
 
-    /// Destructor - ensures clean shutdown
-    ~Logger()
+    /// Whether entries at level pass the minimum level (one relaxed load)
+    bool is_enabled(Level level) const noexcept
     {
-        shut_down();
+        return level >= mMinLevel.load(std::memory_order_relaxed);
     }
 
-    /// Signals worker thread to exit and joins it
-    void shut_down()
+    /// Changes the minimum level (Config::minLevel) at run time; any thread
+    void set_level(Level level) noexcept
     {
-        {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mIsRunning = false;
+        mMinLevel.store(level, std::memory_order_relaxed);
+    }
+
+    /// Current minimum level
+    Level level() const noexcept
+    {
+        return mMinLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Blocks until every entry queued before this call has been written and flushed.
+     *
+     * Inserts a barrier marker into the queue; the worker flushes its sinks when it reaches
+     * the marker and then wakes the caller. Enqueuing the marker is a normal lock-free push,
+     * so other threads keep logging while the caller waits. The logger keeps running.
+     *
+     * @param timeout Maximum time to wait. Zero (default) waits indefinitely.
+     * @return true once all prior entries are flushed; false on timeout or if the logger is shut down.
+     */
+    bool flush(std::chrono::milliseconds timeout = std::chrono::milliseconds::zero())
+    {
+        ensure_init();
+
+        if (!mIsRunning) {
+            return false;
         }
 
-        mCV.notify_all();
+        // Ticket order matches queue order: a later ticket's marker is always queued after
+        // every entry that preceded an earlier ticket, so completing it covers both.
+        const uint64_t ticket = mFlushRequested.fetch_add(1, std::memory_order_acq_rel) + 1;
 
-        if (mWorkerThread.joinable()) {
-            mWorkerThread.join();
+        LogEntry marker{};
+        marker.command = Command::Flush;
+        marker.flushTicket = ticket;
+        marker.threadId = ThreadInfo::current_id();
+        if (!push_entry(std::move(marker), true)) {
+            return false;
         }
+        wake_worker(true);
+
+        std::unique_lock<std::mutex> lock(mFlushMutex);
+        const auto reached = [this, ticket] { return mFlushCompleted >= ticket; };
 
-        if (mFileStream.is_open()) {
-            mFileStream.flush();
-            mFileStream.close();
+        if (timeout <= std::chrono::milliseconds::zero()) {
+            mFlushCV.wait(lock, reached);
+            return true;
         }
+        return mFlushCV.wait_for(lock, timeout, reached);
     }
 
-    void setup_signal_handlers() {
-        std::signal(SIGSEGV, signal_handler); // Segmentation fault
-        std::signal(SIGABRT, signal_handler); // Abort
-        std::signal(SIGFPE,  signal_handler); // Floating point exception
-        std::signal(SIGILL,  signal_handler); // Illegal instruction
+    /**
+     * @brief Returns a snapshot of the file sink's fsync count and latency.
+     *
+     * Safe to call from any thread; the worker updates the counters after every sync.
+     */
+    FsyncStats fsync_stats() const noexcept
+    {
+        FsyncStats stats;
+        stats.count      = mFsyncCount.load(std::memory_order_relaxed);
+        stats.failures   = mFsyncFailures.load(std::memory_order_relaxed);
+        stats.totalNanos = mFsyncTotalNanos.load(std::memory_order_relaxed);
+        stats.maxNanos   = mFsyncMaxNanos.load(std::memory_order_relaxed);
+        stats.lastNanos  = mFsyncLastNanos.load(std::memory_order_relaxed);
+        return stats;
     }
 
-    void emergency_flush() {
-        if (mFileStream.is_open()) {
-            mFileStream.flush();
-        }
+    /**
+     * @brief Returns a snapshot of the logger's own metrics: queue depth, drops, throughput,
+     * bytes per sink and latency histograms.
+     *
+     * Safe to call from any thread at any time; the worker publishes its counters with relaxed
+     * atomics, so a snapshot taken while it runs may be a few entries behind. Built with
+     * KL_DISABLE_METRICS, only the fields marked "always available" are filled.
+     */
+    LoggerStats stats() const noexcept
+    {
+        LoggerStats result;
+        mMetrics.snapshot(result);
+        result.queueDepth    = mLogEntryQueue.is_allocated() ? mLogEntryQueue.size() : 0;
+        result.queueCapacity = mLogEntryQueue.is_allocated() ? mLogEntryQueue.capacity() : 0;
+        result.dropped       = mDropped.load(std::memory_order_relaxed);
+        result.rateLimited   = mRateLimited.load(std::memory_order_relaxed);
+        result.repeated      = mRepeated.load(std::memory_order_relaxed);
+        result.consoleSuppressed = mConsoleSuppressed.load(std::memory_order_relaxed);
+        result.fsync         = fsync_stats();
+        #ifndef _WIN32
+            result.syslogSent    = mSyslog.sent();
+            result.syslogDropped = mSyslog.dropped();
+            if (mShmRing.is_open()) {
+                result.sharedMemoryBytes = mShmRing.header()->writePos.load(std::memory_order_relaxed);
+            }
+        #endif
+        return result;
     }
 
-    static void signal_handler(int signal_num) {
-        const char* msg = "\nProgram crashed! Flushing logs...\n";
-        
-        #ifdef _WIN32
-            _write(1, msg, (unsigned int)strlen(msg));
-        #else
-            write(STDOUT_FILENO, msg, strlen(msg));
-        #endif
+    /**
+     * @brief Asks the worker to write the flight recorder's held lines to the log file.
+     *
+     * Asynchronous: the dump happens in queue order, after every entry logged before this call.
+     * No-op if the flight recorder is disabled (Config::flightRecorderEntries == 0).
+     */
+    void dump_flight_recorder()
+    {
+        ensure_init();
+
+        LogEntry marker{};
+        marker.command = Command::DumpFlightRecorder;
+        marker.threadId = ThreadInfo::current_id();
+        if (push_entry(std::move(marker), true)) {
+            wake_worker(true);
+        }
+    }
 
-        get_instance().emergency_flush();
+    /// Number of entries discarded because the queue was full (OverflowPolicy::Drop)
+    uint64_t dropped_count() const noexcept
+    {
+        return mDropped.load(std::memory_order_relaxed);
+    }
 
-        std::signal(signal_num, SIG_DFL);
-        std::raise(signal_num);
+    /**
+     * @brief Gives the calling thread an alternate signal stack, so that a stack overflow on
+     * this thread can still be reported by the crash handler. Call once per thread.
+     * The thread that calls init() and the worker thread are covered automatically.
+     */
+    static bool install_crash_stack() noexcept
+    {
+        return Crash::install_alt_stack();
     }
 
     /**
-     * @brief Formats a time_point into a fixed-size char buffer using snprintf (zero allocation).
+     * @brief Forces immediate flush of all queued logs and shuts down the worker thread.
      *
-     * Format: DD-MM-YYYY HH:MM:SS.mmm
+     * Called automatically from destructor, but can be called manually before program exit
+     * if strict ordering or immediate flush is required.
+     */
+    void flush_and_shutdown()
+    {
+        shut_down();
+    }
+
+private:
+    /**
+     * @brief Common path of the call-site overloads: rate limit, then an entry whose message
+     * setMessage fills in, then enqueue().
      *
-     * @param tp     Time point to format
-     * @param buffer Destination buffer (must be at least 64 bytes)
-     * @param size   Size of the destination buffer
+     * The limiter runs on steady_clock, so a wall-clock step back (NTP, manual change) cannot
+     * leave its schedule hours ahead and silence the call site. setMessage runs only for
+     * admitted entries.
      */
-    void format_timestamp(const std::chrono::system_clock::time_point& tp, char* buffer, size_t size) const
+    template <typename SetMessage>
+    void submit(const SourceSite& site, RateLimiter& limiter, bool writeToFile, uint32_t sampleRate, SetMessage&& setMessage)
     {
-        const auto time_t_val = std::chrono::system_clock::to_time_t(tp);
-        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()) % 1000;
+        ensure_init();
 
-        std::tm tm_val{};
-        #if defined(_WIN32)
-                localtime_s(&tm_val, &time_t_val);
-        #else
-                localtime_r(&time_t_val, &tm_val);
-        #endif
+        const auto now = std::chrono::system_clock::now();
+        const RateLimitNanos& limit = mRateLimits[static_cast<size_t>(site.level)];
+        uint32_t suppressed = 0;
+        if (limit.intervalNanos != 0) {
+            const int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (!limiter.try_acquire(nanos, limit.intervalNanos, limit.toleranceNanos)) {
+                mRateLimited.fetch_add(1, std::memory_order_relaxed);   // Counted now: the site may never log again
+                return;
+            }
+            suppressed = limiter.take_suppressed();
+        }
 
-        std::snprintf(buffer, size, "%02d-%02d-%04d %02d:%02d:%02d.%03d",
-                      tm_val.tm_mday, tm_val.tm_mon + 1, tm_val.tm_year + 1900,
-                      tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec,
-                      static_cast<int>(ms.count()));
+        LogEntry entry{writeToFile, now, site.level, std::string(), &site};
+        entry.suppressed = suppressed;
+        entry.sampleRate = sampleRate;
+        setMessage(entry);
+        enqueue(std::move(entry));
     }
 
-    /// Converts Level enum to string literal
-    constexpr const char* level_to_string(Level level) const noexcept
+    /// Whether FLOG_ entries are copied into shared memory on the logging thread
+    bool shared_memory_sink_open() const noexcept
     {
-        switch (level) {
-            case Level::INFO:    return "INFO";
-            case Level::WARNING: return "WARNING";
-            case Level::ERROR:   return "ERROR";
-            default:             return "UNKNOWN";
-        }
+        #ifndef _WIN32
+            return mShmRing.is_open();
+        #else
+            return false;
+        #endif
     }
 
-    /// Returns ANSI color escape sequence for the given level
-    constexpr const char* get_color_code(Level level) const noexcept
+    /// Hot-path guard: starts with default settings unless init() already ran (one acquire load)
+    void ensure_init()
     {
-        switch (level) {
-            case Level::INFO:    return "\033[92m"; // Bright Green
-            case Level::WARNING: return "\033[93m"; // Bright Yellow
-            case Level::ERROR:   return "\033[91m"; // Bright Red
-            default:             return "\033[0m";  // Reset
+        if (!mInitialized.load(std::memory_order_acquire)) {
+            init();
         }
     }
 
-    /// Background thread main loop - processes queued log entries
-    void process_queue()
+    /// Pushes an entry onto the queue and wakes the worker
+    void enqueue(LogEntry&& entry)
     {
-        std::queue<LogEntry> localQueue;
+        ensure_init();
 
-        char timeBuffer[64]{};   // Stack-allocated timestamp buffer
-        std::string lineBuffer;
-        lineBuffer.reserve(512); // Pre-allocate for typical log size
+        if (!is_enabled(entry.level)) {
+            return;
+        }
 
-        while (true)
-        {
-            {
-                std::unique_lock<std::mutex> lock(mMutex);
-                mCV.wait(lock, [this] { return !mLogEntryQueue.empty() || !mIsRunning; });
+        entry.threadId = ThreadInfo::current_id();
 
-                if (!mIsRunning && mLogEntryQueue.empty()) {
-                    break;
+        #ifndef _WIN32
+            // Shared-memory mode: the file copy goes straight into the segment, the collector writes it
+            if (entry.writeToFile && mShmRing.is_open()) {
+                if (entry.level >= mFileLevel) {
+                    write_shared_memory(entry);
                 }
-
-                std::swap(localQueue, mLogEntryQueue);  // Release lock as fast as possible
+                entry.writeToFile = false;
             }
+        #endif
 
-            while (!localQueue.empty())
-            {
-                const auto& entry = localQueue.front();
-                const Level& level = entry.level;
-
-                // Format timestamp without allocation
-                format_timestamp(entry.timeStamp, timeBuffer, sizeof(timeBuffer));
-
-                // Build final line (single allocation at most)
-                lineBuffer.clear();
-                lineBuffer += '[';
-                lineBuffer += timeBuffer;
-                lineBuffer += "][";
-                lineBuffer += level_to_string(level);
-                lineBuffer += "][";
-                lineBuffer += entry.msg;
-                lineBuffer += ']';
-
-                // Write to file if requested
-                if (entry.writeToFile) {
-                    write_to_file(lineBuffer);
-                }
+        if (push_entry(std::move(entry), mOverflowPolicy == OverflowPolicy::Block)) {
+            wake_worker();
+        }
+    }
 
-                // Write to console with color
-                if (Level::ERROR == level) {
-                    std::cerr << get_color_code(level) << lineBuffer << Color::RESET << std::endl;
+    /// Creates the shared-memory ring named in the config (POSIX only)
+    void open_shared_memory(const Config& config)
+    {
+        #ifndef _WIN32
+            if (config.flightRecorderEntries != 0) {
+                std::cerr << "[Logger] flightRecorderEntries is ignored when sharedMemoryName is set" << std::endl;
+            }
+            if (!mShmRing.create(config.sharedMemoryName, config.sharedMemoryBytes)) {
+                if (errno == EBUSY) {
+                    std::cerr << "[Logger] Shared-memory ring " << config.sharedMemoryName << " still holds undrained records"
+                              << " or belongs to a running process; drain it with kl-collector or remove it"
+                              << " (falling back to the file sink)" << std::endl;
                 }
                 else {
-                    std::cout << get_color_code(level) << lineBuffer << Color::RESET << "\n";
+                    std::cerr << "[Logger] Failed to create shared-memory ring " << config.sharedMemoryName
+                              << ": " << std::strerror(errno) << " (falling back to the file sink)" << std::endl;
                 }
-
-                localQueue.pop();
             }
-        }
+        #else
+            (void)config;
+            std::cerr << "[Logger] sharedMemoryName is not supported on Windows (using the file sink)" << std::endl;
+        #endif
     }
 
-    /// Writes a line to the current log file, creating a new one if necessary
-    void write_to_file(const std::string& msg)
+    /// Creates the syslog / journald socket named in the config (POSIX only)
+    void open_syslog(const Config& config)
     {
-        if (!mFileStream.is_open() || mCurrentLineCount >= mMaxLines) {
-            create_new_file();
-        }
-
-        if (mFileStream.is_open()) {
-            mFileStream << msg << '\n';
-            ++mCurrentLineCount;
-        }
-        // If file still not open → silently drop (disk full, permission, etc.)
-        // Critical applications may want to log this to stderr
+        mSyslogLevel = config.syslogLevel;
+        #ifndef _WIN32
+            if (!mSyslog.open(config.syslogProtocol, config.syslogSocketPath, config.syslogIdentifier, config.syslogFacility)) {
+                std::cerr << "[Logger] Failed to open syslog socket: " << std::strerror(errno) << std::endl;
+            }
+            else if (!mSyslog.is_connected()) {
+                std::cerr << "[Logger] No listener on " << mSyslog.path()
+                          << " yet (syslog entries are dropped until one appears)" << std::endl;
+            }
+        #else
+            std::cerr << "[Logger] syslogProtocol is not supported on Windows (ignored)" << std::endl;
+        #endif
     }
 
-    /// Closes current file and opens a new one with timestamped name
-    void create_new_file()
+    /// Queues an entry for the syslog sink if it is open and the level qualifies
+    void syslog_add(const LogEntry& entry)
     {
-        if (mFileStream.is_open()) {
-            mFileStream.flush();
-            mFileStream.close();
-        }
-
-        const auto now = std::chrono::system_clock::now();
-        const auto time_t_val = std::chrono::system_clock::to_time_t(now);
-        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-
-        std::tm tm_val{};
-        #if defined(_WIN32)
-                localtime_s(&tm_val, &time_t_val);
+        #ifndef _WIN32
+            if (mSyslog.is_open() && entry.level >= mSyslogLevel) {
+                mSyslog.add(entry.level, entry.timeStamp, entry.threadId, entry.site, entry.msg, mSanitize);
+            }
         #else
-                localtime_r(&time_t_val, &tm_val);
+            (void)entry;
         #endif
+    }
 
-        char filename[128];
-        std::snprintf(filename, sizeof(filename),
-                      "klog_%02d-%02d-%04d-%02d-%02d-%02d-%03d.txt",
-                      tm_val.tm_mday, tm_val.tm_mon + 1, tm_val.tm_year + 1900,
-                      tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec,
-                      static_cast<int>(ms.count()));
+    /// Sends the syslog datagrams of the batch (one sendmmsg)
+    void flush_syslog() noexcept
+    {
+        #ifndef _WIN32
+            mSyslog.flush();
+        #endif
+    }
 
-        const std::filesystem::path fullPath = mLogDirectory / filename;
-        mFileStream.open(fullPath, std::ios::out | std::ios::app);
+    #ifndef _WIN32
+    /// Producer side: copies one entry into the shared-memory ring (lock-free, never blocks)
+    void write_shared_memory(const LogEntry& entry)
+    {
+        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            entry.timeStamp.time_since_epoch()).count();
 
-        if (!mFileStream.is_open()) {
-            std::cerr << "[Logger] CRITICAL: Failed to open log file: " << fullPath << std::endl;
+        if (!mShmRing.try_write(entry.level, entry.threadId, static_cast<int64_t>(nanos), entry.msg.data(), entry.msg.size())) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
         }
+    }
+    #endif
 
-        mCurrentLineCount = 0;
+    /**
+     * @brief Lock-free push; when the ring is full either waits for the worker or drops.
+     * @return false if the entry was dropped.
+     */
+    bool push_entry(LogEntry&& entry, bool block)
+    {
+        while (!mLogEntryQueue.try_push(std::move(entry))) {
+            if (!block || !mIsRunning) {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wake_worker();
+            std::this_thread::yield();
+        }
+        return true;
     }
 
-    // Member variables
-    std::queue<LogEntry> mLogEntryQueue;
-    std::condition_variable mCV;
-    std::mutex mMutex;
-    std::thread mWorkerThread;
+    /**
+     * @brief Wakes the worker if it is asleep on mCV; otherwise costs one fence and a load.
+     *
+     * Either this thread sees the worker's sleeping state, or the worker's re-check after
+     * publishing it sees the entry just pushed (both sides use a seq_cst fence). The empty
+     * critical section makes sure the worker is already waiting on mCV before it is notified.
+     *
+     * @param urgent Also end a batch-scheduler wait that has not reached batchMinEntries (flush markers)
+     *
+     * A pooled logger instead hands itself to its WorkerPool (see WorkerPool::notify()).
+     */
+    void wake_worker(bool urgent = false)
+    {
+        if (mPool != nullptr) {
+            mPool->notify(*this);
+            return;
+        }
 
-    std::atomic<bool> mIsRunning {false};
-    std::once_flag mInitFlag;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const WorkerState state = mWorkerState.load(std::memory_order_relaxed);
+        if (state == WorkerState::Running) {
+            return;
+        }
+        if (state == WorkerState::Accumulating && !urgent && mLogEntryQueue.size() < mBatchMinEntries) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+        }
+        mCV.notify_one();
+    }
+
+    /// Signals worker thread to exit and joins it
+    void shut_down()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsRunning = false;
+        }
+
+        mCV.notify_all();
+
+        if (mWorkerThread.joinable()) {
+            mWorkerThread.join();
+        }
+
+        if (mPool != nullptr && !mPoolDetached) {
+            // Take the logger back from the pool, then drain what is left on this thread.
+            // mPool stays set: a late producer's notify() still reads it, and a detached
+            // client is never queued again (see WorkerPool::detach())
+            mPool->detach(*this);
+            mPoolDetached = true;
+            while (drain_some(mLogEntryQueue.capacity())) {}
+        }
+
+        close_file();
+
+        #ifndef _WIN32
+            mSyslog.close();
+
+            // The segment name stays: the collector drains what is left, then unlinks it
+            mShmRing.mark_closed();
+        #endif
+    }
+
+    /**
+     * @brief Installs the async-signal-safe crash handler (SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS)
+     * and registers this instance in the slots it dumps.
+     */
+    void setup_signal_handlers()
+    {
+        if (mCrashStackTrace) {
+            StackTrace::prepare();
+        }
+
+        for (size_t i = 0; i < kMaxCrashLoggers && mCrashSlot < 0; ++i) {
+            Logger* expected = nullptr;
+            if (sCrashLoggers[i].compare_exchange_strong(expected, this)) {
+                mCrashSlot = static_cast<int>(i);
+            }
+        }
+        if (mCrashSlot < 0) {
+            std::cerr << "[Logger] More than " << kMaxCrashLoggers
+                      << " loggers use the crash handler; this one is not dumped on a crash" << std::endl;
+            return;
+        }
+        Crash::install_handlers(&Logger::signal_handler);
+        Crash::install_alt_stack();
+    }
+
+    /**
+     * @brief Crash callback: for every registered logger, dumps everything not yet written,
+     * then the stack trace. Runs inside the signal handler.
+     *
+     * Only write(2) on descriptors opened earlier, atomic loads and plain reads are used;
+     * the queue is walked through its slot sequence numbers without taking any lock.
+     */
+    static void signal_handler(int signalNumber)
+    {
+        void* frames[StackTrace::kMaxFrames];
+        int frameCount = -1;    // Captured once, on the first logger that wants it
+
+        for (auto& slot : sCrashLoggers) {
+            Logger* logger = slot.load();
+            if (logger == nullptr) {
+                continue;
+            }
+
+            // No file opened yet: open(2) is async-signal-safe, and the path was built at init
+            int fileFd = logger->mCrashFd.load();
+            if (fileFd < 0 && !logger->mCrashPath.empty()) {
+                fileFd = IO::open_append(logger->mCrashPath.c_str());
+            }
+
+            logger->emergency_flush(2, false, signalNumber);
+            logger->emergency_flush(fileFd, true, signalNumber);
+
+            if (logger->mCrashStackTrace) {
+                if (frameCount < 0) {
+                    frameCount = StackTrace::capture(frames, StackTrace::kMaxFrames);
+                    StackTrace::write(2, frames, frameCount);
+                }
+                StackTrace::write(fileFd, frames, frameCount);
+            }
+        }
+    }
+
+    /**
+     * @brief Writes pending log data to fd. Async-signal-safe.
+     *
+     * @param fd          Destination descriptor (stderr or the open log file)
+     * @param fileSink    true: file-bound entries plus the worker's unwritten file buffer;
+     *                    false: the unwritten console batch plus every pending entry (what the console would have shown)
+     * @param signalNumber Signal being handled, recorded in the dump header
+     */
+    void emergency_flush(int fd, bool fileSink, int signalNumber) const noexcept
+    {
+        if (fd < 0) {
+            return;
+        }
+
+        Crash::SafeWriter out(fd);
+
+        // Lines the worker already formatted but had not written yet (best effort)
+        if (fileSink && mFileBuffer.size() <= mFileBuffer.capacity()) {
+            out.append(mFileBuffer.data(), mFileBuffer.size());
+        }
+        if (!fileSink && mConsoleBuffer.size() <= mConsoleBuffer.capacity()) {
+            out.append(mConsoleBuffer.data(), mConsoleBuffer.size());
+        }
+
+        // Context the flight recorder was holding back from the file
+        if (fileSink && mFlightRecorder.size() != 0) {
+            out.append("[kLogger] flight recorder (crash):\n");
+            mFlightRecorder.for_each([&out](const char* line, size_t length) {
+                out.append(line, length);
+                out.append_char('\n');
+            });
+        }
+
+        out.append("[kLogger] crash (signal ");
+        out.append_uint(static_cast<uint64_t>(signalNumber));
+        out.append("): pending entries follow\n");
+
+        mLogEntryQueue.for_each_pending([&](const LogEntry& entry) {
+            if (entry.command != Command::None || (fileSink && !entry.writeToFile)) {
+                return;
+            }
+            append_crash_line(out, entry);
+        });
+
+        out.flush();
+    }
+
+    /// Signal-safe variant of build_line()
+    void append_crash_line(Crash::SafeWriter& out, const LogEntry& entry) const noexcept
+    {
+        const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+            entry.timeStamp.time_since_epoch()).count();
+
+        out.append_char('[');
+        out.append_timestamp(static_cast<int64_t>(millis), mUtcOffsetSeconds);
+        out.append("][");
+        out.append(level_to_string(entry.level));
+        out.append("][");
+        if (mShowThread) {
+            out.append_char('T');
+            out.append_uint(entry.threadId);
+            out.append("][");
+        }
+        if (mShowSourceLocation && entry.site != nullptr) {
+            out.append(entry.site->file);
+            out.append_char(':');
+            out.append_uint(static_cast<uint64_t>(entry.site->line));
+            out.append_char(' ');
+            out.append(entry.site->function);
+            out.append("][");
+        }
+        if ((entry.deferred || entry.render != nullptr) && entry.site != nullptr) {
+            // Never produced: the callable cannot run in a signal handler, show its source instead
+            out.append("(deferred) ");
+            out.append(entry.site->format);
+        }
+        else if (mSanitize) {
+            out.append_escaped(entry.msg.data(), entry.msg.size());
+        }
+        else {
+            out.append(entry.msg.data(), entry.msg.size());
+        }
+        out.append("]\n");
+    }
+
+    /// Seconds east of UTC right now; captured at init for the signal-safe timestamp formatter
+    static int64_t local_utc_offset()
+    {
+        const std::time_t now = std::time(nullptr);
+        #if defined(_WIN32)
+            long seconds = 0;
+            _get_timezone(&seconds);
+            std::tm tm_val{};
+            localtime_s(&tm_val, &now);
+            return -static_cast<int64_t>(seconds) + (tm_val.tm_isdst > 0 ? 3600 : 0);
+        #else
+            std::tm tm_val{};
+            localtime_r(&now, &tm_val);
+            return static_cast<int64_t>(tm_val.tm_gmtoff);
+        #endif
+    }
+
+    /**
+     * @brief Formats a time_point into a fixed-size char buffer from the digit-pair table
+     * (zero allocation, no snprintf).
+     *
+     * Format: DD-MM-YYYY HH:MM:SS.mmm
+     *
+     * @param tp     Time point to format
+     * @param buffer Destination buffer (must be at least 24 bytes; callers use 64)
+     * @param size   Size of the destination buffer
+     */
+    void format_timestamp(const std::chrono::system_clock::time_point& tp, char* buffer, size_t size) const
+    {
+        const auto time_t_val = std::chrono::system_clock::to_time_t(tp);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()) % 1000;
+
+        std::tm tm_val{};
+        #if defined(_WIN32)
+                localtime_s(&tm_val, &time_t_val);
+        #else
+                localtime_r(&time_t_val, &tm_val);
+        #endif
+
+        if (size < 24) {
+            if (size > 0) {
+                buffer[0] = '\0';
+            }
+            return;
+        }
+
+        const unsigned year = static_cast<unsigned>(tm_val.tm_year + 1900) % 10000;
+        const unsigned millis = static_cast<unsigned>(ms.count());
+        char* out = Format::write_2digits(buffer, static_cast<unsigned>(tm_val.tm_mday));
+        *out++ = '-';
+        out = Format::write_2digits(out, static_cast<unsigned>(tm_val.tm_mon + 1));
+        *out++ = '-';
+        out = Format::write_2digits(out, year / 100);
+        out = Format::write_2digits(out, year % 100);
+        *out++ = ' ';
+        out = Format::write_2digits(out, static_cast<unsigned>(tm_val.tm_hour));
+        *out++ = ':';
+        out = Format::write_2digits(out, static_cast<unsigned>(tm_val.tm_min));
+        *out++ = ':';
+        out = Format::write_2digits(out, static_cast<unsigned>(tm_val.tm_sec));
+        *out++ = '.';
+        *out++ = static_cast<char>('0' + millis / 100);
+        out = Format::write_2digits(out, millis % 100);
+        *out = '\0';
+    }
+
+    /// Converts Level enum to string literal
+    constexpr const char* level_to_string(Level level) const noexcept
+    {
+        return level_name(level);
+    }
+
+    /// Returns ANSI color escape sequence for the given level
+    constexpr const char* get_color_code(Level level) const noexcept
+    {
+        switch (level) {
+            case Level::INFO:    return "\033[92m"; // Bright Green
+            case Level::WARNING: return "\033[93m"; // Bright Yellow
+            case Level::ERROR:   return "\033[91m"; // Bright Red
+            default:             return "\033[0m";  // Reset
+        }
+    }
+
+    /// Resolves Config::consoleColor for one console stream
+    static bool use_color(ColorMode mode, int fd) noexcept
+    {
+        switch (mode) {
+            case ColorMode::Always: return true;
+            case ColorMode::Never:  return false;
+            case ColorMode::Auto:
+            default:
+                break;
+        }
+
+        // https://no-color.org: present and non-empty disables color
+        const char* noColor = std::getenv("NO_COLOR");
+        if (noColor != nullptr && noColor[0] != '\0') {
+            return false;
+        }
+        const char* term = std::getenv("TERM");
+        if (term != nullptr && std::strcmp(term, "dumb") == 0) {
+            return false;
+        }
+        return IO::is_terminal(fd);
+    }
+
+    /// Appends "file:line function" for the given call site
+    void append_source_location(std::string& out, const SourceSite& site) const
+    {
+        out += site.file;
+        out += ':';
+        Format::append_int(out, site.line);
+        out += ' ';
+        out += site.function;
+    }
+
+    /// Appends "T<id>" or "T<id>:<name>" for the producing thread
+    void append_thread(std::string& out, uint32_t threadId)
+    {
+        const uint64_t generation = ThreadInfo::names_generation();
+        if (generation != mThreadNamesGeneration) {
+            mThreadNamesGeneration = ThreadInfo::copy_names(mThreadNames);
+        }
+
+        out += 'T';
+        Format::append_uint(out, threadId);
+
+        if (threadId < mThreadNames.size() && !mThreadNames[threadId].empty()) {
+            out += ':';
+            out += mThreadNames[threadId];
+        }
+    }
+
+    /**
+     * @brief Formats one entry into lineBuffer: [time][LEVEL][thread][site][sampled 1/N][msg]
+     *
+     * The optional [thread] and [site] fields appear only when enabled in the Config;
+     * [sampled 1/N] only on entries logged through the *_SAMPLED macros.
+     *
+     * @param entry      Entry to format
+     * @param timeBuffer Scratch buffer for the timestamp
+     * @param timeSize   Size of timeBuffer
+     * @param lineBuffer Output (cleared first)
+     */
+    void build_line(const LogEntry& entry, char* timeBuffer, size_t timeSize, std::string& lineBuffer)
+    {
+        // Format timestamp without allocation
+        format_timestamp(entry.timeStamp, timeBuffer, timeSize);
+
+        // Build final line (single allocation at most)
+        lineBuffer.clear();
+        lineBuffer += '[';
+        lineBuffer += timeBuffer;
+        lineBuffer += "][";
+        lineBuffer += level_to_string(entry.level);
+        lineBuffer += "][";
+        if (mShowThread) {
+            append_thread(lineBuffer, entry.threadId);
+            lineBuffer += "][";
+        }
+        if (mShowSourceLocation && entry.site != nullptr) {
+            append_source_location(lineBuffer, *entry.site);
+            lineBuffer += "][";
+        }
+        if (entry.sampleRate > 1) {
+            lineBuffer += "sampled 1/";
+            Format::append_uint(lineBuffer, entry.sampleRate);
+            lineBuffer += "][";
+        }
+        if (mSanitize) {
+            Sanitizer::append_sanitized(lineBuffer, entry.msg);
+        }
+        else {
+            lineBuffer += entry.msg;
+        }
+        lineBuffer += ']';
+    }
+
+    /**
+     * @brief Runs first on the worker thread: name, CPU affinity and scheduling class, then
+     * allocate_worker_buffers().
+     *
+     * Allocating after pinning makes the first touch of the queue slots and the flight
+     * recorder happen on the worker's CPU, so Linux's default NUMA policy places those pages
+     * on the worker's node. Placement failures are reported and otherwise ignored.
+     */
+    void place_worker(const Config& config)
+    {
+        if (!config.workerThreadName.empty()) {
+            ThreadPlacement::set_name(config.workerThreadName);
+        }
+        if (!config.workerCpus.empty() && !ThreadPlacement::pin(config.workerCpus)) {
+            std::cerr << "[Logger] Failed to pin the worker thread: " << std::strerror(errno) << std::endl;
+        }
+        if (!ThreadPlacement::set_scheduling(config.workerPolicy, config.workerPriority)) {
+            std::cerr << "[Logger] Failed to set the worker scheduling policy: " << std::strerror(errno) << std::endl;
+        }
+
+        allocate_worker_buffers(config);
+    }
+
+    /// Entry queue, flight recorder and sink buffers: everything drain_some() needs
+    void allocate_worker_buffers(const Config& config)
+    {
+        mLogEntryQueue.allocate(config.queueCapacity);
+        if (config.sharedMemoryName.empty()) {
+            mFlightRecorder.allocate(config.flightRecorderEntries, config.flightRecorderEntryBytes);
+        }
+        mLineBuffer.reserve(512);   // Pre-allocate for typical log size
+        mFileBuffer.reserve(kFileBufferLimit);
+        mConsoleBuffer.reserve(kConsoleBufferLimit);
+    }
+
+    /// Background thread main loop - processes queued log entries
+    void process_queue()
+    {
+        if (mCrashSlot >= 0) {
+            Crash::install_alt_stack();
+        }
+
+        while (wait_for_work())
+        {
+            if (mBatchMaxDelay.count() > 0) {
+                accumulate_batch();
+            }
 
-    std::ofstream mFileStream;
+            // Bounded batch: under sustained load the file buffer and fsync policy still get their turn
+            drain_some(mLogEntryQueue.capacity());
+        }
+    }
+
+    /**
+     * @brief Processes at most budget queued entries as one batch: one write() per sink, then
+     * the fsync policy and the periodic stats line.
+     *
+     * Runs on the worker thread, or on whichever WorkerPool thread currently owns the logger.
+     * @return true if entries are still queued.
+     */
+    bool drain_some(size_t budget) override
+    {
+        char timeBuffer[64]{};   // Stack-allocated timestamp buffer
+        std::string& lineBuffer = mLineBuffer;
+
+        bool wroteError = false;
+        size_t written = 0;
+        const size_t depth = LoggerMetrics::kEnabled ? mLogEntryQueue.size() : 0;
+
+        if (mConsoleThrottled) {
+            roll_console_window(std::chrono::steady_clock::now());
+        }
+
+        for (size_t processed = 0; processed < budget; ++processed)
+        {
+            LogEntry* next = mLogEntryQueue.front();
+            if (next == nullptr) {
+                break;
+            }
+
+            const auto& entry = *next;
+            const Level& level = entry.level;
+
+            if (entry.command != Command::None) {
+                run_command(entry);
+                mLogEntryQueue.pop();
+                continue;
+            }
+
+            if (next->deferred || next->render != nullptr) {
+                run_deferred(*next);
+            }
+
+            if (mDeduplicate) {
+                if (is_repeat(entry)) {
+                    if (mRepeatCount++ == 0) {
+                        mRepeatReportDue = std::chrono::steady_clock::now() + kRepeatReportInterval;
+                    }
+                    mRepeatSuppressed += entry.suppressed;
+                    mLastRepeatTime = entry.timeStamp;
+                    mLogEntryQueue.pop();
+                    continue;
+                }
+                write_repeat_summary();
+                remember_for_dedup(entry);
+            }
+
+            if (entry.suppressed != 0) {
+                write_notice(entry, std::to_string(entry.suppressed) + " messages suppressed by the rate limit");
+            }
+
+            build_line(entry, timeBuffer, sizeof(timeBuffer), lineBuffer);
+
+            const bool toFile = entry.writeToFile && level >= mFileLevel;
+
+            // Flight recorder: keep what is not written; spill it all when a trigger level arrives
+            if (mFlightRecorder.enabled()) {
+                if (level >= mFlightRecorderTrigger) {
+                    dump_flight_recorder_to_file(level_to_string(level));
+                    if (!toFile) {
+                        write_to_file(lineBuffer);
+                    }
+                    // The dump is what FsyncPolicy::OnError is for, even when the trigger is console-only
+                    wroteError = wroteError || (Level::ERROR == level);
+                }
+                else if (!toFile) {
+                    mFlightRecorder.record(lineBuffer.data(), lineBuffer.size());
+                }
+            }
+
+            // Write to file if requested
+            if (toFile) {
+                write_to_file(lineBuffer);
+                wroteError = wroteError || (Level::ERROR == level);
+            }
+
+            // Write to console (unless over its Config::consoleLinesPerSecond cap)
+            if (!mConsoleThrottled || console_admits(level, toFile)) {
+                write_to_console(level, lineBuffer);
+            }
+
+            syslog_add(entry);
+
+            if (LoggerMetrics::kEnabled) {
+                // Clock reads dominate the instrumentation cost: time one entry in kLatencySampleEvery
+                const bool sampled = (mMetricsEntrySeq++ % LoggerMetrics::kLatencySampleEvery) == 0;
+                mMetrics.on_entry_written(!sampled ? -1 :
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - entry.timeStamp).count());
+                ++written;
+            }
+
+            mLogEntryQueue.pop();
+        }
+
+        // A repetition still going on is summarized at shutdown and at least every kRepeatReportInterval
+        if (mRepeatCount != 0 && (!mIsRunning || std::chrono::steady_clock::now() >= mRepeatReportDue)) {
+            write_repeat_summary();
+        }
+        if (mConsoleWindowSuppressed && !mIsRunning) {
+            mConsoleWindowEnd = {};
+            roll_console_window(std::chrono::steady_clock::now());
+        }
+
+        // One write() per sink for the whole batch, then at most one sync
+        flush_console_buffer();
+        flush_file_buffer();
+        flush_syslog();
+        apply_fsync_policy(wroteError);
+
+        mMetrics.on_batch(depth, written);
+        if (mMetricsInterval.count() > 0 && std::chrono::steady_clock::now() - mLastMetricsReport >= mMetricsInterval) {
+            report_stats();
+        }
+
+        return !mLogEntryQueue.empty();
+    }
+
+    /**
+     * @brief Waits until the queue has entries, a timer is due, or the logger stops.
+     *
+     * Follows the configured WaitStrategy: poll (spin, then yield) before parking on mCV.
+     * mWorkerState is Parked only while the worker sleeps on mCV; producers skip the
+     * notify otherwise (see wake_worker()).
+     *
+     * @return false once the logger is stopped and the queue is drained.
+     */
+    bool wait_for_work()
+    {
+        const auto hasWork = [this] { return !mLogEntryQueue.empty() || !mIsRunning; };
+
+        if (mWaitStrategy == WaitStrategy::BusyPoll) {
+            for (uint32_t polls = 1; !hasWork(); ++polls) {
+                cpu_relax();
+                if ((polls & 1023) == 0 && std::chrono::steady_clock::now() >= next_timer_deadline()) {
+                    run_timers();
+                }
+            }
+            return mIsRunning || !mLogEntryQueue.empty();
+        }
+
+        if (mWaitStrategy == WaitStrategy::Adaptive) {
+            for (size_t i = 0; i < mSpinIterations; ++i) {
+                if (hasWork()) {
+                    return mIsRunning || !mLogEntryQueue.empty();
+                }
+                cpu_relax();
+            }
+            for (size_t i = 0; i < mYieldIterations; ++i) {
+                if (hasWork()) {
+                    return mIsRunning || !mLogEntryQueue.empty();
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        // Advertise the sleep, then re-check: pairs with the fence in wake_worker()
+        mWorkerState.store(WorkerState::Parked, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Sleep no longer than the next interval sync or stats report
+        const auto deadline = next_timer_deadline();
+        bool timedOut = false;
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            mCV.wait(lock, hasWork);
+        }
+        else {
+            timedOut = !mCV.wait_until(lock, deadline, hasWork);
+        }
+
+        mWorkerState.store(WorkerState::Running, std::memory_order_relaxed);
+        lock.unlock();
+
+        if (timedOut) {
+            run_timers();
+            return true;
+        }
+        return mIsRunning || !mLogEntryQueue.empty();
+    }
+
+    /**
+     * @brief Batch scheduler (Config::batchMaxDelay): lets entries pile up before a drain.
+     *
+     * Sleeps in the Accumulating state, in which producers notify only once batchMinEntries
+     * are pending, until that happens, the delay expires, a flush() is requested or the logger
+     * stops. BusyPoll polls instead of sleeping.
+     */
+    void accumulate_batch()
+    {
+        const auto ready = [this] {
+            return mLogEntryQueue.size() >= mBatchMinEntries || !mIsRunning
+                || mFlushRequested.load(std::memory_order_acquire) > mFlushCompleted;
+        };
+        if (mLogEntryQueue.empty() || ready()) {
+            return;
+        }
+
+        const auto batchDeadline = std::chrono::steady_clock::now() + mBatchMaxDelay;
+
+        if (mWaitStrategy == WaitStrategy::BusyPoll) {
+            while (!ready() && std::chrono::steady_clock::now() < batchDeadline) {
+                cpu_relax();
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkerState.store(WorkerState::Accumulating, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        mCV.wait_until(lock, std::min(batchDeadline, next_timer_deadline()), ready);
+
+        mWorkerState.store(WorkerState::Running, std::memory_order_relaxed);
+        lock.unlock();
+        run_timers();
+    }
+
+    /// Pause hint for spin loops (lets the sibling hyper-thread run, saves power)
+    static void cpu_relax() noexcept
+    {
+        #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+        #elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_ia32_pause();
+        #elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || defined(__arm__))
+            __asm__ __volatile__("yield");
+        #endif
+    }
+
+    /// Earliest time the worker must wake up without new entries (time_point::max() = none)
+    std::chrono::steady_clock::time_point next_timer_deadline() const
+    {
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        if (mFsyncPolicy == FsyncPolicy::Interval && mUnsyncedBytes > 0) {
+            deadline = mLastSync + mFsyncInterval;
+        }
+        if (mMetricsInterval.count() > 0 && mLastMetricsReport + mMetricsInterval < deadline) {
+            deadline = mLastMetricsReport + mMetricsInterval;
+        }
+        if (mRepeatCount != 0 && mRepeatReportDue < deadline) {
+            deadline = mRepeatReportDue;
+        }
+        if (mConsoleWindowSuppressed && mConsoleWindowEnd < deadline) {
+            deadline = mConsoleWindowEnd;
+        }
+        return deadline;
+    }
+
+    /// Runs whatever timer-driven work is due (interval fsync, periodic stats line, repeat and console summaries)
+    void run_timers()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (mConsoleWindowSuppressed && now >= mConsoleWindowEnd) {
+            roll_console_window(now);
+            flush_console_buffer();
+        }
+        if (mRepeatCount != 0 && now >= mRepeatReportDue) {
+            write_repeat_summary();
+            flush_console_buffer();
+            flush_file_buffer();
+            flush_syslog();
+        }
+        if (mFsyncPolicy == FsyncPolicy::Interval && mUnsyncedBytes > 0 && now - mLastSync >= mFsyncInterval) {
+            sync_file();
+        }
+        if (mMetricsInterval.count() > 0 && now - mLastMetricsReport >= mMetricsInterval) {
+            report_stats();
+        }
+    }
+
+    /// Writes a one-line stats() summary to the log file (Config::metricsInterval)
+    void report_stats()
+    {
+        mLastMetricsReport = std::chrono::steady_clock::now();
+
+        const LoggerStats current = stats();
+        const auto micros = [](uint64_t nanos) { return static_cast<unsigned long long>(nanos / 1000); };
+
+        char text[512];
+        int length = std::snprintf(text, sizeof(text),
+            "kLogger stats: queue=%zu/%zu dropped=%llu rate_limited=%llu repeated=%llu console_suppressed=%llu syslog_dropped=%llu fsync=%llu",
+            current.queueDepth, current.queueCapacity,
+            static_cast<unsigned long long>(current.dropped),
+            static_cast<unsigned long long>(current.rateLimited),
+            static_cast<unsigned long long>(current.repeated),
+            static_cast<unsigned long long>(current.consoleSuppressed),
+            static_cast<unsigned long long>(current.syslogDropped),
+            static_cast<unsigned long long>(current.fsync.count));
+
+        if (current.enabled && length > 0 && static_cast<size_t>(length) < sizeof(text)) {
+            length += std::snprintf(text + length, sizeof(text) - static_cast<size_t>(length),
+                " high=%zu written=%llu batches=%llu batch_p50/p99=%llu/%llu"
+                " latency_us_p50/p99/max=%llu/%llu/%llu write_us_p99=%llu"
+                " file_bytes=%llu console_bytes=%llu rotations=%llu",
+                current.queueHighWater,
+                static_cast<unsigned long long>(current.written),
+                static_cast<unsigned long long>(current.batches),
+                static_cast<unsigned long long>(current.batchSize.p50),
+                static_cast<unsigned long long>(current.batchSize.p99),
+                micros(current.enqueueToWriteNanos.p50),
+                micros(current.enqueueToWriteNanos.p99),
+                micros(current.enqueueToWriteNanos.max),
+                micros(current.fileWriteNanos.p99),
+                static_cast<unsigned long long>(current.fileBytes),
+                static_cast<unsigned long long>(current.consoleBytes),
+                static_cast<unsigned long long>(current.rotations));
+        }
+
+        LogEntry entry{true, std::chrono::system_clock::now(), Level::INFO, std::string(text)};
+        entry.threadId = ThreadInfo::current_id();
+
+        char timeBuffer[64]{};
+        std::string line;
+        build_line(entry, timeBuffer, sizeof(timeBuffer), line);
+        write_to_file(line);
+        flush_file_buffer();
+    }
+
+    /// Syncs the file if the configured FsyncPolicy says this batch needs it
+    void apply_fsync_policy(bool wroteError)
+    {
+        if (mUnsyncedBytes == 0) {
+            return;
+        }
+
+        switch (mFsyncPolicy) {
+            case FsyncPolicy::Interval:
+                if (std::chrono::steady_clock::now() - mLastSync >= mFsyncInterval) {
+                    sync_file();
+                }
+                break;
+            case FsyncPolicy::Bytes:
+                if (mUnsyncedBytes >= mFsyncBytes) {
+                    sync_file();
+                }
+                break;
+            case FsyncPolicy::OnError:
+                if (wroteError) {
+                    sync_file();
+                }
+                break;
+            case FsyncPolicy::None:
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Appends a line to the console batch (stdout), or writes an ERROR line to stderr at once.
+     *
+     * stdout lines queued before an ERROR are written first, so the two streams stay in order.
+     * Lines are colored only when the stream's color was enabled at init (use_color()).
+     */
+    void write_to_console(Level level, const std::string& line)
+    {
+        const bool isError = (Level::ERROR == level);
+        if (isError) {
+            flush_console_buffer();
+        }
+
+        if (isError ? mColorStderr : mColorStdout) {
+            mConsoleBuffer += get_color_code(level);
+            mConsoleBuffer += line;
+            mConsoleBuffer += Color::RESET;
+        }
+        else {
+            mConsoleBuffer += line;
+        }
+        mConsoleBuffer += '\n';
+        mMetrics.on_console_write(line.size() + 1);
+
+        if (isError) {
+            IO::write_all(kStderrFd, mConsoleBuffer.data(), mConsoleBuffer.size());
+            mConsoleBuffer.clear();
+        }
+        else if (mConsoleBuffer.size() >= kConsoleBufferLimit) {
+            flush_console_buffer();
+        }
+    }
+
+    /// Writes the pending stdout lines with a single write() call
+    void flush_console_buffer()
+    {
+        if (mConsoleBuffer.empty()) {
+            return;
+        }
+        IO::write_all(kStdoutFd, mConsoleBuffer.data(), mConsoleBuffer.size());
+        mConsoleBuffer.clear();
+    }
+
+    /// Writes the pending file buffer with a single write() call
+    void flush_file_buffer()
+    {
+        if (mFileBuffer.empty()) {
+            return;
+        }
+
+        const auto start = LoggerMetrics::kEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        if (mFileFd >= 0 && IO::write_all(mFileFd, mFileBuffer.data(), mFileBuffer.size())) {
+            mUnsyncedBytes += mFileBuffer.size();
+            if (LoggerMetrics::kEnabled) {
+                mMetrics.on_file_write(mFileBuffer.size(), static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+            }
+        }
+        // On failure → silently drop (disk full, permission, etc.)
+        mFileBuffer.clear();
+    }
+
+    /// fdatasync()s the current file and records its latency
+    void sync_file()
+    {
+        if (mFileFd < 0) {
+            mUnsyncedBytes = 0;
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = IO::sync_data(mFileFd);
+        mLastSync = std::chrono::steady_clock::now();
+        mUnsyncedBytes = 0;
+
+        const auto nanos = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(mLastSync - start).count());
+
+        mFsyncCount.fetch_add(1, std::memory_order_relaxed);
+        mFsyncTotalNanos.fetch_add(nanos, std::memory_order_relaxed);
+        mFsyncLastNanos.store(nanos, std::memory_order_relaxed);
+        if (nanos > mFsyncMaxNanos.load(std::memory_order_relaxed)) {
+            mFsyncMaxNanos.store(nanos, std::memory_order_relaxed); // Single writer (worker)
+        }
+        if (!ok) {
+            mFsyncFailures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// Writes out pending data, syncs it unless FsyncPolicy::None, and closes the file
+    void close_file()
+    {
+        if (mFileFd < 0) {
+            return;
+        }
+
+        flush_file_buffer();
+        if (mFsyncPolicy != FsyncPolicy::None && mUnsyncedBytes > 0) {
+            sync_file();
+        }
+
+        mCrashFd.store(-1);
+        IO::close(mFileFd);
+        mFileFd = -1;
+        mUnsyncedBytes = 0;
+    }
+
+    /// Executes a control marker taken from the queue
+    void run_command(const LogEntry& entry)
+    {
+        switch (entry.command) {
+            case Command::Flush:
+                write_repeat_summary();
+                complete_flush(entry.flushTicket);
+                break;
+            case Command::DumpFlightRecorder:
+                dump_flight_recorder_to_file("request");
+                break;
+            case Command::None:
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Produces a deferred or encoded entry's message on the worker; a throwing callable
+     * or Codec leaves a note instead.
+     *
+     * Encoded text is rendered into mRenderBuffer and swapped in, so the buffer keeps the
+     * capacity of the argument bytes for the next entry.
+     */
+    void run_deferred(LogEntry& entry)
+    {
+        try {
+            if (entry.render != nullptr) {
+                mRenderBuffer.clear();
+                entry.render(mRenderBuffer, entry.msg);
+                entry.msg.swap(mRenderBuffer);
+            }
+            else {
+                entry.deferred.invoke(entry.msg);
+            }
+        }
+        catch (const std::exception& e) {
+            entry.msg = std::string("[deferred message threw: ") + e.what() + "]";
+        }
+        catch (...) {
+            entry.msg = "[deferred message threw]";
+        }
+        entry.deferred = DeferredMessage();
+        entry.render = nullptr;
+    }
+
+    /// Whether entry repeats the last one written (Config::deduplicate); the thread may differ
+    bool is_repeat(const LogEntry& entry) const noexcept
+    {
+        return mHaveLastEntry
+            && entry.level == mLastLevel
+            && entry.writeToFile == mLastWriteToFile
+            && entry.site == mLastSite
+            && entry.msg == mLastMessage;
+    }
+
+    /// Keeps what is_repeat() compares against (copies the text into a reused buffer)
+    void remember_for_dedup(const LogEntry& entry)
+    {
+        mHaveLastEntry = true;
+        mLastLevel = entry.level;
+        mLastWriteToFile = entry.writeToFile;
+        mLastSite = entry.site;
+        mLastThreadId = entry.threadId;
+        mLastMessage.assign(entry.msg);
+    }
+
+    /**
+     * @brief Writes "last message repeated N times" for the repetitions collapsed so far, plus
+     * the rate-limit suppressions those repetitions carried.
+     */
+    void write_repeat_summary()
+    {
+        if (mRepeatCount == 0) {
+            return;
+        }
+
+        std::string text = "last message repeated " + std::to_string(mRepeatCount) + " times";
+        if (mRepeatSuppressed != 0) {
+            text += " (" + std::to_string(mRepeatSuppressed) + " more suppressed by the rate limit)";
+        }
+
+        LogEntry like{mLastWriteToFile, mLastRepeatTime, mLastLevel, std::string(), mLastSite};
+        like.threadId = mLastThreadId;
+        write_notice(like, std::move(text));
+
+        mRepeated.fetch_add(mRepeatCount, std::memory_order_relaxed);
+        mRepeatCount = 0;
+        mRepeatSuppressed = 0;
+    }
+
+    /**
+     * @brief Takes one line of level's console budget for the current window (Config::consoleLinesPerSecond).
+     * @param toFile Whether the line also went to the file (for the summary)
+     */
+    bool console_admits(Level level, bool toFile) noexcept
+    {
+        ConsoleCap& cap = mConsoleCaps[static_cast<size_t>(level)];
+        if (cap.linesPerWindow == 0 || cap.used < cap.linesPerWindow) {
+            ++cap.used;
+            return true;
+        }
+        ++cap.suppressed;
+        cap.suppressedInFile += toFile ? 1 : 0;
+        mConsoleWindowSuppressed = true;
+        mConsoleSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// Starts a new console window once the current one is over, first printing what it held back
+    void roll_console_window(std::chrono::steady_clock::time_point now)
+    {
+        if (now < mConsoleWindowEnd) {
+            return;
+        }
+        mConsoleWindowEnd = now + kConsoleWindow;
+
+        for (size_t i = 0; i < kLevelCount; ++i) {
+            ConsoleCap& cap = mConsoleCaps[i];
+            if (cap.suppressed != 0) {
+                std::string text = "kLogger: " + std::to_string(cap.suppressed) + " " + level_to_string(static_cast<Level>(i))
+                                 + " lines suppressed on console (" + std::to_string(cap.suppressedInFile) + " in the log file)";
+                const LogEntry like{false, std::chrono::system_clock::now(), static_cast<Level>(i), std::string()};
+                write_notice(like, std::move(text), false);
+            }
+            cap.used = 0;
+            cap.suppressed = 0;
+            cap.suppressedInFile = 0;
+        }
+        mConsoleWindowSuppressed = false;
+    }
+
+    /**
+     * @brief Writes a logger-generated line to the sinks that `like` goes to, with its timestamp, site and thread.
+     * @param toSyslog Also forward it to the syslog sink (not for notes about the console itself)
+     */
+    void write_notice(const LogEntry& like, std::string text, bool toSyslog = true)
+    {
+        LogEntry notice{like.writeToFile, like.timeStamp, like.level, std::move(text), like.site};
+        notice.threadId = like.threadId;
+
+        char timeBuffer[64]{};
+        build_line(notice, timeBuffer, sizeof(timeBuffer), mLineBuffer);
+        if (notice.writeToFile && notice.level >= mFileLevel) {
+            write_to_file(mLineBuffer);
+        }
+        write_to_console(notice.level, mLineBuffer);
+        if (toSyslog) {
+            syslog_add(notice);
+        }
+    }
+
+    /// Writes every line held by the flight recorder to the file sink, framed by header/footer lines
+    void dump_flight_recorder_to_file(const char* reason)
+    {
+        if (mFlightRecorder.size() == 0) {
+            return;
+        }
+
+        std::string frame = "[kLogger] flight recorder: last " + std::to_string(mFlightRecorder.size())
+                          + " unwritten entries (trigger: " + reason + ")";
+        write_to_file(frame);
+
+        mFlightRecorder.for_each([this, &frame](const char* line, size_t length) {
+            frame.assign(line, length);
+            write_to_file(frame);
+        });
+
+        write_to_file("[kLogger] end of flight recorder");
+        mFlightRecorder.clear();
+    }
+
+    /// Flushes every sink, then releases flush() callers waiting on tickets up to `ticket`
+    void complete_flush(uint64_t ticket)
+    {
+        flush_file_buffer();
+        if (mUnsyncedBytes > 0) {
+            sync_file();
+        }
+        flush_console_buffer();
+        flush_syslog();
+
+        {
+            std::lock_guard<std::mutex> lock(mFlushMutex);
+            if (ticket > mFlushCompleted) {
+                mFlushCompleted = ticket;
+            }
+        }
+        mFlushCV.notify_all();
+    }
+
+    /// Writes a line to the current log file, creating a new one if necessary
+    void write_to_file(const std::string& msg)
+    {
+        if (mFileFd < 0 || mCurrentLineCount >= mMaxLines) {
+            create_new_file();
+        }
+
+        if (mFileFd >= 0) {
+            mFileBuffer += msg;
+            mFileBuffer += '\n';
+            ++mCurrentLineCount;
+
+            if (mFileBuffer.size() >= kFileBufferLimit) {
+                flush_file_buffer();
+            }
+        }
+        // If file still not open → silently drop (disk full, permission, etc.)
+        // Critical applications may want to log this to stderr
+    }
+
+    /// Closes current file and opens a new one with timestamped name
+    void create_new_file()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        close_file();
+
+        const auto now = std::chrono::system_clock::now();
+        const auto time_t_val = std::chrono::system_clock::to_time_t(now);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+
+        std::tm tm_val{};
+        #if defined(_WIN32)
+                localtime_s(&tm_val, &time_t_val);
+        #else
+                localtime_r(&time_t_val, &tm_val);
+        #endif
+
+        char filename[256];
+        std::snprintf(filename, sizeof(filename),
+                      "%s_%02d-%02d-%04d-%02d-%02d-%02d-%03d.txt", mFilePrefix.c_str(),
+                      tm_val.tm_mday, tm_val.tm_mon + 1, tm_val.tm_year + 1900,
+                      tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec,
+                      static_cast<int>(ms.count()));
+
+        const std::filesystem::path fullPath = mLogDirectory / filename;
+        mFileFd = IO::open_append(fullPath);
+        mCrashFd.store(mFileFd);
+        mLastSync = std::chrono::steady_clock::now();
+
+        if (mFileFd < 0) {
+            std::cerr << "[Logger] CRITICAL: Failed to open log file: " << fullPath << std::endl;
+        }
+        else {
+            mMetrics.on_rotation(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(mLastSync - start).count()));
+        }
+
+        mCurrentLineCount = 0;
+    }
+
+    // Member variables
+    RingQueue<LogEntry> mLogEntryQueue;
+    std::condition_variable mCV;
+    std::mutex mMutex;
+    std::thread mWorkerThread;
+
+    std::atomic<bool> mIsRunning {false};
+    // Worker idle handling (see wait_for_work(), accumulate_batch())
+    enum class WorkerState : uint8_t {
+        Running,        ///< Draining or polling: producers never notify
+        Parked,         ///< Asleep on mCV: any push notifies
+        Accumulating    ///< Batch scheduler wait: notify once batchMinEntries are pending
+    };
+    std::atomic<WorkerState> mWorkerState{WorkerState::Running};
+    std::shared_ptr<WorkerPool> mPoolOwner; // Keeps the pool alive until the logger is destroyed
+    WorkerPool* mPool{nullptr};             // Set: drained by the pool, no mWorkerThread; never reset
+    bool mPoolDetached{false};              // shut_down() took the logger back from the pool
+    WaitStrategy mWaitStrategy{WaitStrategy::Adaptive};
+    size_t mSpinIterations{1000};
+    size_t mYieldIterations{10};
+    std::chrono::microseconds mBatchMaxDelay{0};
+    size_t mBatchMinEntries{0};
+    std::once_flag mInitFlag;
+    std::atomic<bool> mInitialized{false};  // Set once init() has finished; see ensure_init()
+    std::atomic<Level> mMinLevel{Level::INFO};
+    OverflowPolicy mOverflowPolicy{OverflowPolicy::Block};
+    std::atomic<uint64_t> mDropped{0};
+
+    // flush() barrier state: tickets are issued atomically, completed under mFlushMutex
+    std::atomic<uint64_t> mFlushRequested{0};
+    uint64_t mFlushCompleted{0};
+    std::mutex mFlushMutex;
+    std::condition_variable mFlushCV;
+
+    // File sink: raw descriptor + batch buffer (written once per drained batch)
+    static constexpr size_t kFileBufferLimit = 64 * 1024;
+    int mFileFd{-1};
+    std::string mFileBuffer;
+    std::string mLineBuffer;    // Line being formatted by drain_some()
+    std::string mRenderBuffer;  // Text of an encoded entry (run_deferred())
+
+    // Console sink: stdout batch buffer; ERROR lines go straight to stderr
+    static constexpr int kStdoutFd = 1;
+    static constexpr int kStderrFd = 2;
+    static constexpr size_t kConsoleBufferLimit = 64 * 1024;
+    std::string mConsoleBuffer;
+
+    // Call-site rate limits per level (Config::rateLimits); intervalNanos == 0 = unlimited
+    struct RateLimitNanos {
+        int64_t intervalNanos{0};
+        int64_t toleranceNanos{0};
+    };
+    RateLimitNanos mRateLimits[kLevelCount]{};
+    std::atomic<uint64_t> mRateLimited{0};      // Rejected by a call-site limiter, counted by the producer
+
+    // Worker-side dedup of consecutive identical entries (Config::deduplicate)
+    static constexpr std::chrono::seconds kRepeatReportInterval{1};
+    bool mDeduplicate{false};
+    bool mHaveLastEntry{false};
+    Level mLastLevel{Level::INFO};
+    bool mLastWriteToFile{false};
+    const SourceSite* mLastSite{nullptr};
+    uint32_t mLastThreadId{0};
+    std::string mLastMessage;
+    uint64_t mRepeatCount{0};
+    uint64_t mRepeatSuppressed{0};      // Rate-limit suppressions carried by the collapsed entries
+    std::chrono::system_clock::time_point mLastRepeatTime{};
+    std::chrono::steady_clock::time_point mRepeatReportDue{};
+    std::atomic<uint64_t> mRepeated{0};
+
+    // Worker-side console cap (Config::consoleLinesPerSecond), in fixed one-second windows
+    struct ConsoleCap {
+        uint64_t linesPerWindow = 0;    // 0 = no cap
+        uint64_t used = 0;
+        uint64_t suppressed = 0;
+        uint64_t suppressedInFile = 0;
+    };
+    static constexpr std::chrono::seconds kConsoleWindow{1};
+    ConsoleCap mConsoleCaps[kLevelCount]{};
+    bool mConsoleThrottled{false};          // Any level capped
+    bool mConsoleWindowSuppressed{false};   // The current window held lines back
+    std::chrono::steady_clock::time_point mConsoleWindowEnd{};
+    std::atomic<uint64_t> mConsoleSuppressed{0};
+
+    // Crash path: the loggers the signal handler dumps (fixed slots, no allocation), and the
+    // descriptor each one writes to
+    static constexpr size_t kMaxCrashLoggers = 32;
+    static inline std::atomic<Logger*> sCrashLoggers[kMaxCrashLoggers]{};
+    int mCrashSlot{-1};
+    std::atomic<int> mCrashFd{-1};
+    std::string mCrashPath;                 // Fallback file when no log file is open yet
+    bool mCrashStackTrace{true};
+    int64_t mUtcOffsetSeconds{0};
     std::filesystem::path mLogDirectory;
+    std::string mFilePrefix{"klog"};
     size_t mMaxLines{100000};
     size_t mCurrentLineCount{0};
+    bool mSanitize{false};
+    bool mShowSourceLocation{false};
+    bool mShowThread{false};
+    bool mColorStdout{true};    // Config::consoleColor resolved per stream
+    bool mColorStderr{true};
+    Level mFileLevel{Level::INFO};
+
+    #ifndef _WIN32
+        ShmRing mShmRing;   // Shared-memory file path (Config::sharedMemoryName)
+        SyslogSink mSyslog; // Host log (Config::syslogProtocol)
+    #endif
+    Level mSyslogLevel{Level::INFO};
+
+    // Flight recorder (worker-owned, preallocated at init)
+    FlightRecorder mFlightRecorder;
+    Level mFlightRecorderTrigger{Level::ERROR};
+
+    // Durability (see FsyncPolicy)
+    FsyncPolicy mFsyncPolicy{FsyncPolicy::None};
+    std::chrono::milliseconds mFsyncInterval{1000};
+    size_t mFsyncBytes{1024 * 1024};
+    size_t mUnsyncedBytes{0};
+    std::chrono::steady_clock::time_point mLastSync{};
+
+    // fsync latency counters, read by fsync_stats()
+    std::atomic<uint64_t> mFsyncCount{0};
+    std::atomic<uint64_t> mFsyncFailures{0};
+    std::atomic<uint64_t> mFsyncTotalNanos{0};
+    std::atomic<uint64_t> mFsyncMaxNanos{0};
+    std::atomic<uint64_t> mFsyncLastNanos{0};
+
+    // Self-instrumentation (see stats()); updated by the worker only
+    LoggerMetrics mMetrics;
+    uint64_t mMetricsEntrySeq{0};
+    std::chrono::milliseconds mMetricsInterval{0};
+    std::chrono::steady_clock::time_point mLastMetricsReport{};
+
+    // Worker-side copy of the thread name table (see ThreadInfo.h)
+    std::vector<std::string> mThreadNames;
+    uint64_t mThreadNamesGeneration{0};
 };
 
 } // namespace KL
@@ -2,6 +2,7 @@
 #define MACROS_H
 
 #include "Logger.h" // Logger sınıfının tanımını içerdiğinden emin olun
+#include "Registry.h"
 
 /**
  * @file LogMacros.h
@@ -9,8 +10,102 @@
  * 
  * LOG_ prefix: Writes only to the terminal (Console).
  * FLOG_ prefix: Writes to both the terminal and the log file.
+ * _TO suffix: Logs through the logger registered under a name (see KL::Registry) instead of
+ *             the default instance.
+ * _SAMPLED suffix: Keeps 1 in `rate` executions at random (see KL::Sampling); the message
+ *             expression is only evaluated for kept lines, which carry a [sampled 1/rate] field.
+ * _DEFERRED suffix: Takes a callable returning the message and runs it on the worker thread
+ *             (see Logger::log_deferred()); capture by value.
+ * LOGF_ / FLOGF_ prefix: Takes a format string and arguments, LOGF_INFO("{} ms", ms)
+ *             (see KL::Format); with _DEFERRED the arguments are serialized (KL::Codec) and
+ *             formatted by the worker.
+ *
+ * The message expression is evaluated only when its level is enabled (Config::minLevel,
+ * Logger::set_level()) and the call site's rate limit admits the line (Config::rateLimits);
+ * any macro also accepts a callable returning the message.
+ *
+ * Every expansion records its call site (file, line, function, level, message expression)
+ * in a function-local `static constexpr KL::SourceSite`; only the pointer is queued. It also
+ * owns a constant-initialized KL::RateLimiter for Config::rateLimits.
+ * Define KL_STRIP_SOURCE_PATH=1 to keep just the file name.
  */
 
+/**
+ * @brief Common body of all logging macros.
+ * @param level  KL::Level value
+ * @param msg    The message string (std::string compatible), or a callable returning it
+ * @param toFile Whether the entry also goes to the log file
+ */
+#define KL_LOG_AT_SITE(level, msg, toFile)                                                  \
+    do {                                                                                    \
+        KL::Logger& klLogger = KL::Logger::get_instance();                                  \
+        if (klLogger.is_enabled(level)) {                                                   \
+            static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__,                \
+                                                   KL_SOURCE_FUNCTION, level, #msg};        \
+            static KL::RateLimiter klLimiter;                                               \
+            klLogger.log(klSite, klLimiter, [&] { return KL::message_of(msg); }, toFile);   \
+        }                                                                                   \
+    } while (false)
+
+/**
+ * @brief KL_LOG_AT_SITE for a format string and its arguments (KL::format), formatted only
+ * when the line passes the level and the rate limit.
+ */
+#define KL_LOGF_AT_SITE(level, toFile, ...)                                                 \
+    do {                                                                                    \
+        KL::Logger& klLogger = KL::Logger::get_instance();                                  \
+        if (klLogger.is_enabled(level)) {                                                   \
+            static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__,                \
+                                                   KL_SOURCE_FUNCTION, level, #__VA_ARGS__}; \
+            static KL::RateLimiter klLimiter;                                               \
+            klLogger.log(klSite, klLimiter, [&] { return KL::format(__VA_ARGS__); }, toFile); \
+        }                                                                                   \
+    } while (false)
+
+/// KL_LOGF_AT_SITE with the arguments serialized here and formatted on the worker (KL::Codec)
+#define KL_LOGF_DEFERRED_AT_SITE(level, toFile, ...)                                        \
+    do {                                                                                    \
+        KL::Logger& klLogger = KL::Logger::get_instance();                                  \
+        if (klLogger.is_enabled(level)) {                                                   \
+            static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__,                \
+                                                   KL_SOURCE_FUNCTION, level, #__VA_ARGS__}; \
+            static KL::RateLimiter klLimiter;                                               \
+            klLogger.log_encoded(klSite, klLimiter, toFile, __VA_ARGS__);                   \
+        }                                                                                   \
+    } while (false)
+
+/**
+ * @brief KL_LOG_AT_SITE for a callable run on the worker thread (Logger::log_deferred()).
+ * Variadic so lambdas with several captures need no extra parentheses.
+ */
+#define KL_LOG_DEFERRED_AT_SITE(level, toFile, ...)                                         \
+    do {                                                                                    \
+        KL::Logger& klLogger = KL::Logger::get_instance();                                  \
+        if (klLogger.is_enabled(level)) {                                                   \
+            static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__,                \
+                                                   KL_SOURCE_FUNCTION, level, #__VA_ARGS__}; \
+            static KL::RateLimiter klLimiter;                                               \
+            klLogger.log_deferred(klSite, klLimiter, __VA_ARGS__, toFile);                  \
+        }                                                                                   \
+    } while (false)
+
+/**
+ * @brief KL_LOG_AT_SITE for a named logger. The name is resolved once per call site and
+ * resolved again only after the registry changes.
+ * @param name   Registered logger name (const char*); unknown names use the default instance
+ */
+#define KL_LOG_AT_SITE_TO(name, level, msg, toFile)                                         \
+    do {                                                                                    \
+        static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__, KL_SOURCE_FUNCTION, \
+                                               level, #msg};                                \
+        static KL::RateLimiter klLimiter;                                                   \
+        static KL::Registry::SiteCache klLoggerCache;                                       \
+        KL::Logger& klLogger = KL::Registry::resolve(klLoggerCache, name);                  \
+        if (klLogger.is_enabled(level)) {                                                   \
+            klLogger.log(klSite, klLimiter, [&] { return KL::message_of(msg); }, toFile);   \
+        }                                                                                   \
+    } while (false)
+
 // -----------------------------------------------------------------------------
 // CONSOLE ONLY LOGGING MACROS (writeToFile = false)
 // -----------------------------------------------------------------------------
@@ -20,21 +115,21 @@
  * @param msg The message string (std::string compatible).
  */
 #define LOG_INFO(msg) \
-    KL::Logger::get_instance().log(KL::Level::INFO, msg, false)
+    KL_LOG_AT_SITE(KL::Level::INFO, msg, false)
 
 /**
  * @brief Logs a WARNING message to the console only.
  * @param msg The message string (std::string compatible).
  */
 #define LOG_WARNING(msg) \
-    KL::Logger::get_instance().log(KL::Level::WARNING, msg, false)
+    KL_LOG_AT_SITE(KL::Level::WARNING, msg, false)
 
 /**
  * @brief Logs an ERROR message to the console only.
  * @param msg The message string (std::string compatible).
  */
 #define LOG_ERROR(msg) \
-    KL::Logger::get_instance().log(KL::Level::ERROR, msg, false)
+    KL_LOG_AT_SITE(KL::Level::ERROR, msg, false)
 
 
 // -----------------------------------------------------------------------------
@@ -46,20 +141,173 @@
  * @param msg The message string (std::string compatible).
  */
 #define FLOG_INFO(msg) \
-    KL::Logger::get_instance().log(KL::Level::INFO, msg, true)
+    KL_LOG_AT_SITE(KL::Level::INFO, msg, true)
 
 /**
  * @brief Logs a WARNING message to the console AND the log file.
  * @param msg The message string (std::string compatible).
  */
 #define FLOG_WARNING(msg) \
-    KL::Logger::get_instance().log(KL::Level::WARNING, msg, true)
+    KL_LOG_AT_SITE(KL::Level::WARNING, msg, true)
 
 /**
  * @brief Logs an ERROR message to the console AND the log file.
  * @param msg The message string (std::string compatible).
  */
 #define FLOG_ERROR(msg) \
-    KL::Logger::get_instance().log(KL::Level::ERROR, msg, true)
+    KL_LOG_AT_SITE(KL::Level::ERROR, msg, true)
+
+
+/**
+ * @brief KL_LOG_AT_SITE for 1 in `rate` executions, decided before msg is evaluated.
+ * @param rate Keep one line in this many (unsigned; 0 or 1 keeps every line)
+ */
+#define KL_LOG_SAMPLED_AT_SITE(level, rate, msg, toFile)                                    \
+    do {                                                                                    \
+        const uint32_t klRate = static_cast<uint32_t>(rate);                                \
+        KL::Logger& klLogger = KL::Logger::get_instance();                                  \
+        if (klLogger.is_enabled(level) && KL::Sampling::keep(klRate)) {                     \
+            static constexpr KL::SourceSite klSite{KL_SOURCE_FILE, __LINE__,                \
+                                                   KL_SOURCE_FUNCTION, level, #msg};        \
+            static KL::RateLimiter klLimiter;                                               \
+            klLogger.log(klSite, klLimiter, [&] { return KL::message_of(msg); }, toFile, klRate); \
+        }                                                                                   \
+    } while (false)
+
+// -----------------------------------------------------------------------------
+// SAMPLED LOGGING MACROS (1 in `rate` lines, chosen at random)
+// -----------------------------------------------------------------------------
+
+/// LOG_INFO for 1 in rate executions
+#define LOG_INFO_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::INFO, rate, msg, false)
+
+/// LOG_WARNING for 1 in rate executions
+#define LOG_WARNING_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::WARNING, rate, msg, false)
+
+/// LOG_ERROR for 1 in rate executions
+#define LOG_ERROR_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::ERROR, rate, msg, false)
+
+/// FLOG_INFO for 1 in rate executions
+#define FLOG_INFO_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::INFO, rate, msg, true)
+
+/// FLOG_WARNING for 1 in rate executions
+#define FLOG_WARNING_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::WARNING, rate, msg, true)
+
+/// FLOG_ERROR for 1 in rate executions
+#define FLOG_ERROR_SAMPLED(rate, msg) \
+    KL_LOG_SAMPLED_AT_SITE(KL::Level::ERROR, rate, msg, true)
+
+// -----------------------------------------------------------------------------
+// DEFERRED LOGGING MACROS (message produced on the worker thread)
+// -----------------------------------------------------------------------------
+
+/// LOG_INFO with a by-value callable that the worker runs to produce the message
+#define LOG_INFO_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::INFO, false, __VA_ARGS__)
+
+/// LOG_WARNING with a by-value callable that the worker runs to produce the message
+#define LOG_WARNING_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::WARNING, false, __VA_ARGS__)
+
+/// LOG_ERROR with a by-value callable that the worker runs to produce the message
+#define LOG_ERROR_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::ERROR, false, __VA_ARGS__)
+
+/// FLOG_INFO with a by-value callable that the worker runs to produce the message
+#define FLOG_INFO_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::INFO, true, __VA_ARGS__)
+
+/// FLOG_WARNING with a by-value callable that the worker runs to produce the message
+#define FLOG_WARNING_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::WARNING, true, __VA_ARGS__)
+
+/// FLOG_ERROR with a by-value callable that the worker runs to produce the message
+#define FLOG_ERROR_DEFERRED(...) \
+    KL_LOG_DEFERRED_AT_SITE(KL::Level::ERROR, true, __VA_ARGS__)
+
+// -----------------------------------------------------------------------------
+// FORMATTING MACROS (format string + arguments, see KL::Format)
+// -----------------------------------------------------------------------------
+
+/// LOG_INFO with KL::format("...{}...", args...)
+#define LOGF_INFO(...) \
+    KL_LOGF_AT_SITE(KL::Level::INFO, false, __VA_ARGS__)
+
+/// LOG_WARNING with KL::format("...{}...", args...)
+#define LOGF_WARNING(...) \
+    KL_LOGF_AT_SITE(KL::Level::WARNING, false, __VA_ARGS__)
+
+/// LOG_ERROR with KL::format("...{}...", args...)
+#define LOGF_ERROR(...) \
+    KL_LOGF_AT_SITE(KL::Level::ERROR, false, __VA_ARGS__)
+
+/// FLOG_INFO with KL::format("...{}...", args...)
+#define FLOGF_INFO(...) \
+    KL_LOGF_AT_SITE(KL::Level::INFO, true, __VA_ARGS__)
+
+/// FLOG_WARNING with KL::format("...{}...", args...)
+#define FLOGF_WARNING(...) \
+    KL_LOGF_AT_SITE(KL::Level::WARNING, true, __VA_ARGS__)
+
+/// FLOG_ERROR with KL::format("...{}...", args...)
+#define FLOGF_ERROR(...) \
+    KL_LOGF_AT_SITE(KL::Level::ERROR, true, __VA_ARGS__)
+
+/// LOGF_INFO formatted on the worker thread (see KL::Codec)
+#define LOGF_INFO_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::INFO, false, __VA_ARGS__)
+
+/// LOGF_WARNING formatted on the worker thread (see KL::Codec)
+#define LOGF_WARNING_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::WARNING, false, __VA_ARGS__)
+
+/// LOGF_ERROR formatted on the worker thread (see KL::Codec)
+#define LOGF_ERROR_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::ERROR, false, __VA_ARGS__)
+
+/// FLOGF_INFO formatted on the worker thread (see KL::Codec)
+#define FLOGF_INFO_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::INFO, true, __VA_ARGS__)
+
+/// FLOGF_WARNING formatted on the worker thread (see KL::Codec)
+#define FLOGF_WARNING_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::WARNING, true, __VA_ARGS__)
+
+/// FLOGF_ERROR formatted on the worker thread (see KL::Codec)
+#define FLOGF_ERROR_DEFERRED(...) \
+    KL_LOGF_DEFERRED_AT_SITE(KL::Level::ERROR, true, __VA_ARGS__)
+
+// -----------------------------------------------------------------------------
+// NAMED LOGGER MACROS (see KL::Registry)
+// -----------------------------------------------------------------------------
+
+/// LOG_INFO through the logger registered under name
+#define LOG_INFO_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::INFO, msg, false)
+
+/// LOG_WARNING through the logger registered under name
+#define LOG_WARNING_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::WARNING, msg, false)
+
+/// LOG_ERROR through the logger registered under name
+#define LOG_ERROR_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::ERROR, msg, false)
+
+/// FLOG_INFO through the logger registered under name
+#define FLOG_INFO_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::INFO, msg, true)
+
+/// FLOG_WARNING through the logger registered under name
+#define FLOG_WARNING_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::WARNING, msg, true)
+
+/// FLOG_ERROR through the logger registered under name
+#define FLOG_ERROR_TO(name, msg) \
+    KL_LOG_AT_SITE_TO(name, KL::Level::ERROR, msg, true)
 
 #endif // MACROS_H
\ No newline at end of file
@@ -0,0 +1,324 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>           // For std::atomic
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint64_t, UINT64_MAX
+
+/**
+ * @brief Compile-time switch for the logger's self-instrumentation.
+ *
+ * Define KL_DISABLE_METRICS (or KL_METRICS=0) before including kLogger to compile every
+ * counter and histogram update out of the worker loop. Logger::stats() then reports
+ * `enabled == false` and only the always-on counters (drops, queue depth, fsync).
+ */
+#ifndef KL_METRICS
+    #ifdef KL_DISABLE_METRICS
+        #define KL_METRICS 0
+    #else
+        #define KL_METRICS 1
+    #endif
+#endif
+
+namespace KL {
+    /**
+     * @brief Snapshot of the file sink's fsync activity (see Logger::fsync_stats()).
+     *
+     * Latencies are wall-clock nanoseconds spent inside fdatasync().
+     */
+    struct FsyncStats {
+        uint64_t count = 0;         ///< Number of completed syncs
+        uint64_t failures = 0;      ///< Syncs that returned an error
+        uint64_t totalNanos = 0;    ///< Sum of all sync latencies
+        uint64_t maxNanos = 0;      ///< Slowest sync so far
+        uint64_t lastNanos = 0;     ///< Most recent sync
+    };
+
+    /// Summary of one Histogram. Percentiles are bucket upper bounds (at most ~6% above the true value).
+    struct HistogramSummary {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t min = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+
+        /// Arithmetic mean (0 when empty)
+        double mean() const noexcept { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    /**
+     * @class Histogram
+     * @brief Fixed-size HDR-style histogram of non-negative integers (log-linear buckets).
+     *
+     * Values below 16 get exact buckets; above that every power of two is split into 16
+     * linear sub-buckets, so any value is stored with at most 1/16 relative error over the
+     * whole uint64_t range. Memory is fixed (976 buckets) and recording never allocates.
+     *
+     * record() is meant for a single writer (the worker thread) and uses relaxed
+     * load/store pairs instead of read-modify-write instructions; summary() may run
+     * concurrently on any thread and sees a slightly stale but self-consistent view.
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned kSubBucketBits = 4;
+        static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+        static constexpr size_t kBucketCount = kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+        Histogram() = default;
+
+        Histogram(const Histogram&) = delete;
+        Histogram& operator=(const Histogram&) = delete;
+
+        /// Adds one sample. Single writer.
+        void record(uint64_t value) noexcept
+        {
+            bump(mBuckets[bucket_index(value)], 1);
+            bump(mCount, 1);
+            bump(mSum, value);
+            if (value < mMin.load(std::memory_order_relaxed)) {
+                mMin.store(value, std::memory_order_relaxed);
+            }
+            if (value > mMax.load(std::memory_order_relaxed)) {
+                mMax.store(value, std::memory_order_relaxed);
+            }
+        }
+
+        /// Count, sum, min/max and p50/p90/p99/p99.9 of everything recorded so far
+        HistogramSummary summary() const noexcept
+        {
+            HistogramSummary result;
+            for (const auto& bucket : mBuckets) {
+                result.count += bucket.load(std::memory_order_relaxed);
+            }
+            if (result.count == 0) {
+                return result;
+            }
+
+            result.sum = mSum.load(std::memory_order_relaxed);
+            result.min = mMin.load(std::memory_order_relaxed);
+            result.max = mMax.load(std::memory_order_relaxed);
+
+            struct Target { double quantile; uint64_t* out; };
+            const Target targets[] = {
+                {0.50, &result.p50}, {0.90, &result.p90}, {0.99, &result.p99}, {0.999, &result.p999}
+            };
+
+            size_t next = 0;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount && next < 4; ++i) {
+                seen += mBuckets[i].load(std::memory_order_relaxed);
+                while (next < 4 && static_cast<double>(seen) >= targets[next].quantile * static_cast<double>(result.count)) {
+                    const uint64_t upper = bucket_upper_bound(i);
+                    *targets[next].out = (upper < result.max) ? upper : result.max;
+                    ++next;
+                }
+            }
+            return result;
+        }
+
+        /// Bucket that holds value
+        static size_t bucket_index(uint64_t value) noexcept
+        {
+            if (value < kSubBuckets) {
+                return static_cast<size_t>(value);
+            }
+            const unsigned msb = 63u - static_cast<unsigned>(count_leading_zeros(value));
+            const unsigned shift = msb - kSubBucketBits;
+            const size_t sub = static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+            return kSubBuckets + static_cast<size_t>(shift) * kSubBuckets + sub;
+        }
+
+        /// Largest value that maps to bucket index
+        static uint64_t bucket_upper_bound(size_t index) noexcept
+        {
+            if (index < kSubBuckets) {
+                return static_cast<uint64_t>(index);
+            }
+            const unsigned shift = static_cast<unsigned>((index - kSubBuckets) / kSubBuckets);
+            const uint64_t sub = static_cast<uint64_t>((index - kSubBuckets) % kSubBuckets);
+            const uint64_t lower = (uint64_t{1} << (shift + kSubBucketBits)) | (sub << shift);
+            return lower + ((uint64_t{1} << shift) - 1);
+        }
+
+    private:
+        static void bump(std::atomic<uint64_t>& counter, uint64_t delta) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        static int count_leading_zeros(uint64_t value) noexcept
+        {
+            #if defined(__GNUC__) || defined(__clang__)
+                return __builtin_clzll(value);
+            #else
+                int zeros = 0;
+                for (uint64_t bit = uint64_t{1} << 63; (value & bit) == 0; bit >>= 1) {
+                    ++zeros;
+                }
+                return zeros;
+            #endif
+        }
+
+        std::atomic<uint64_t> mBuckets[kBucketCount]{};
+        std::atomic<uint64_t> mCount{0};
+        std::atomic<uint64_t> mSum{0};
+        std::atomic<uint64_t> mMin{UINT64_MAX};
+        std::atomic<uint64_t> mMax{0};
+    };
+
+    /**
+     * @brief Snapshot of the logger's own behaviour (see Logger::stats()).
+     *
+     * Counters are totals since init(). Latencies are in nanoseconds.
+     */
+    struct LoggerStats {
+        bool enabled = false;               ///< false when built with KL_DISABLE_METRICS (instrumented fields stay 0)
+
+        // Always available
+        size_t queueDepth = 0;              ///< Entries waiting in the queue right now
+        size_t queueCapacity = 0;           ///< Slots in the queue
+        uint64_t dropped = 0;               ///< Entries discarded (full queue or full shared-memory ring)
+        uint64_t rateLimited = 0;           ///< Messages rejected by call-site rate limits
+        uint64_t repeated = 0;              ///< Identical entries collapsed by Config::deduplicate
+        uint64_t consoleSuppressed = 0;     ///< Lines kept off the console by Config::consoleLinesPerSecond (not in consoleLines/consoleBytes)
+        uint64_t syslogSent = 0;            ///< Datagrams handed to the syslog socket (Config::syslogProtocol)
+        uint64_t syslogDropped = 0;         ///< Datagrams dropped: full socket buffer, no listener, or too large
+        FsyncStats fsync;                   ///< File sink syncs
+
+        // Instrumented (KL_METRICS)
+        size_t queueHighWater = 0;          ///< Deepest queue seen by the worker at the start of a batch
+        uint64_t written = 0;               ///< Entries handed to the sinks by the worker
+        uint64_t batches = 0;               ///< Drain passes that processed at least one entry
+        uint64_t fileBytes = 0;             ///< Bytes written to log files
+        uint64_t consoleLines = 0;          ///< Lines written to stdout/stderr (entries and logger notices)
+        uint64_t consoleBytes = 0;          ///< Bytes written to stdout/stderr (without color codes)
+        uint64_t sharedMemoryBytes = 0;     ///< Bytes reserved in the shared-memory ring
+        uint64_t rotations = 0;             ///< Log files opened
+
+        HistogramSummary enqueueToWriteNanos;   ///< Entry timestamp to hand-off to the sinks (sampled)
+        HistogramSummary batchSize;             ///< Entries per drain pass
+        HistogramSummary fileWriteNanos;        ///< Duration of each batched file write()
+        HistogramSummary rotationNanos;         ///< Closing the old file and opening the next one
+    };
+
+    /**
+     * @brief The worker thread's instrumentation state.
+     *
+     * Every update is a no-op when KL_METRICS is 0, so the calls can stay in the worker
+     * loop unconditionally. All updates come from the worker thread.
+     */
+    class LoggerMetrics {
+    public:
+        static constexpr bool kEnabled = (KL_METRICS != 0);
+
+        /// Enqueue-to-write latency is measured for one entry in this many
+        static constexpr uint64_t kLatencySampleEvery = 16;
+
+        void on_batch(size_t queueDepth, size_t entries) noexcept
+        {
+            #if KL_METRICS
+                if (entries == 0) {
+                    return;
+                }
+                if (queueDepth > mQueueHighWater.load(std::memory_order_relaxed)) {
+                    mQueueHighWater.store(queueDepth, std::memory_order_relaxed);
+                }
+                add(mBatches, 1);
+                mBatchSize.record(entries);
+            #else
+                (void)queueDepth;
+                (void)entries;
+            #endif
+        }
+
+        /// One entry handed to the sinks; latencyNanos < 0 means "not sampled"
+        void on_entry_written(int64_t latencyNanos) noexcept
+        {
+            #if KL_METRICS
+                add(mWritten, 1);
+                if (latencyNanos >= 0) {
+                    mEnqueueToWrite.record(static_cast<uint64_t>(latencyNanos));
+                }
+            #else
+                (void)latencyNanos;
+            #endif
+        }
+
+        /// One line actually emitted on stdout/stderr
+        void on_console_write(size_t bytes) noexcept
+        {
+            #if KL_METRICS
+                add(mConsoleLines, 1);
+                add(mConsoleBytes, bytes);
+            #else
+                (void)bytes;
+            #endif
+        }
+
+        void on_file_write(size_t bytes, uint64_t nanos) noexcept
+        {
+            #if KL_METRICS
+                add(mFileBytes, bytes);
+                mFileWrite.record(nanos);
+            #else
+                (void)bytes;
+                (void)nanos;
+            #endif
+        }
+
+        void on_rotation(uint64_t nanos) noexcept
+        {
+            #if KL_METRICS
+                add(mRotations, 1);
+                mRotation.record(nanos);
+            #else
+                (void)nanos;
+            #endif
+        }
+
+        /// Fills the instrumented fields of stats
+        void snapshot(LoggerStats& stats) const noexcept
+        {
+            stats.enabled = kEnabled;
+            #if KL_METRICS
+                stats.queueHighWater      = mQueueHighWater.load(std::memory_order_relaxed);
+                stats.written             = mWritten.load(std::memory_order_relaxed);
+                stats.batches             = mBatches.load(std::memory_order_relaxed);
+                stats.fileBytes           = mFileBytes.load(std::memory_order_relaxed);
+                stats.consoleLines        = mConsoleLines.load(std::memory_order_relaxed);
+                stats.consoleBytes        = mConsoleBytes.load(std::memory_order_relaxed);
+                stats.rotations           = mRotations.load(std::memory_order_relaxed);
+                stats.enqueueToWriteNanos = mEnqueueToWrite.summary();
+                stats.batchSize           = mBatchSize.summary();
+                stats.fileWriteNanos      = mFileWrite.summary();
+                stats.rotationNanos       = mRotation.summary();
+            #endif
+        }
+
+    private:
+        #if KL_METRICS
+            static void add(std::atomic<uint64_t>& counter, uint64_t delta) noexcept
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed); // Single writer
+            }
+
+            std::atomic<size_t> mQueueHighWater{0};
+            std::atomic<uint64_t> mWritten{0};
+            std::atomic<uint64_t> mBatches{0};
+            std::atomic<uint64_t> mFileBytes{0};
+            std::atomic<uint64_t> mConsoleLines{0};
+            std::atomic<uint64_t> mConsoleBytes{0};
+            std::atomic<uint64_t> mRotations{0};
+
+            Histogram mEnqueueToWrite;
+            Histogram mBatchSize;
+            Histogram mFileWrite;
+            Histogram mRotation;
+        #endif
+    };
+}
+
+#endif //! METRICS_H
\ No newline at end of file
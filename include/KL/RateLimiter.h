@@ -0,0 +1,61 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <atomic>           // For std::atomic
+#include <cstdint>          // For int64_t, uint32_t
+
+namespace KL {
+
+/**
+ * @brief Per-call-site rate limiter state (GCRA, the token bucket as a single timestamp).
+ *
+ * Every LOG_ / FLOG_ macro expansion owns one as a function-local static. It is
+ * constant-initialized, so there is no guard variable and no runtime construction.
+ * The limits themselves live in the Logger (Config::rateLimits); this only tracks the
+ * "theoretical arrival time" of the next conforming message and what was rejected.
+ */
+class RateLimiter {
+public:
+    constexpr RateLimiter() noexcept = default;
+
+    /**
+     * @brief Admits one message at nowNanos, or rejects it and counts it as suppressed.
+     *
+     * nowNanos must come from a monotonic clock (the Logger uses steady_clock).
+     *
+     * Lock-free: a load, a compare and one CAS when admitted; a fetch_add when rejected.
+     * @param intervalNanos  Emission interval (1 / rate)
+     * @param toleranceNanos How far ahead of schedule a burst may run ((burst - 1) * interval)
+     */
+    bool try_acquire(int64_t nowNanos, int64_t intervalNanos, int64_t toleranceNanos) noexcept
+    {
+        int64_t tat = mTat.load(std::memory_order_relaxed);
+        while (true) {
+            const int64_t base = (tat > nowNanos) ? tat : nowNanos;
+            if (base - nowNanos > toleranceNanos) {
+                mSuppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (mTat.compare_exchange_weak(tat, base + intervalNanos, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    /// Messages rejected since the last call (read by the next admitted message)
+    uint32_t take_suppressed() noexcept
+    {
+        if (mSuppressed.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        return mSuppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> mTat{0};
+    std::atomic<uint32_t> mSuppressed{0};
+};
+
+} // namespace KL
+
+#endif //! RATELIMITER_H
\ No newline at end of file
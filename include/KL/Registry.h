@@ -0,0 +1,138 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <atomic>           // For std::atomic
+#include <memory>           // For std::unique_ptr
+#include <mutex>            // For std::mutex
+#include <string>           // For std::string
+#include <unordered_map>    // For std::unordered_map
+
+#include "Logger.h"
+
+namespace KL {
+
+/**
+ * @brief Process-wide table of named Logger instances.
+ *
+ * Lets independent components log through their own queue, worker and files without passing
+ * a Logger around, and lets the *_TO macros (Macros.h) target an instance by name:
+ * @code
+ * KL::Config audit;
+ * audit.folderPath = "logs";
+ * audit.filePrefix = "audit";
+ * KL::Registry::create("audit", audit);
+ * FLOG_INFO_TO("audit", "user " + name + " logged in");
+ * @endcode
+ *
+ * Registered loggers live until remove() or program exit, when they flush and shut down like
+ * the default instance. A name that is not registered resolves to Logger::get_instance().
+ */
+class Registry {
+public:
+    /**
+     * @brief Creates, starts and registers a logger.
+     * @return The new logger, or the one already registered under name (config is then ignored).
+     */
+    static Logger& create(const std::string& name, const Config& config)
+    {
+        State& state = get_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        auto it = state.loggers.find(name);
+        if (it != state.loggers.end()) {
+            std::cerr << "[Logger] A logger named " << name << " already exists; keeping it" << std::endl;
+            return *it->second;
+        }
+
+        Logger& logger = *state.loggers.emplace(name, std::make_unique<Logger>(config)).first->second;
+        state.generation.fetch_add(1, std::memory_order_release);
+        return logger;
+    }
+
+    /// The logger registered under name, or nullptr
+    static Logger* find(const std::string& name)
+    {
+        State& state = get_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        auto it = state.loggers.find(name);
+        return (it != state.loggers.end()) ? it->second.get() : nullptr;
+    }
+
+    /// The logger registered under name, or the default instance if there is none
+    static Logger& get(const std::string& name)
+    {
+        Logger* logger = find(name);
+        return (logger != nullptr) ? *logger : Logger::get_instance();
+    }
+
+    /**
+     * @brief Flushes, stops and destroys the logger registered under name.
+     *
+     * No other thread may still be logging to it (directly or through a macro).
+     * @return false if no logger has that name.
+     */
+    static bool remove(const std::string& name)
+    {
+        std::unique_ptr<Logger> removed;
+        {
+            State& state = get_state();
+            std::lock_guard<std::mutex> lock(state.mutex);
+
+            auto it = state.loggers.find(name);
+            if (it == state.loggers.end()) {
+                return false;
+            }
+            removed = std::move(it->second);
+            state.loggers.erase(it);
+            state.generation.fetch_add(1, std::memory_order_release);
+        }
+        return true;    // removed shuts the logger down here, outside the lock
+    }
+
+    /// Per-call-site cache used by the *_TO macros, so a named lookup costs one atomic load
+    struct SiteCache {
+        std::atomic<Logger*> logger{nullptr};
+        std::atomic<uint64_t> generation{0};
+    };
+
+    /**
+     * @brief Resolves name through cache; looks it up again only after create() or remove().
+     *
+     * The cache is refilled under the registry mutex, with the generation read under it too, so
+     * two threads refilling around a create() or remove() cannot leave an old logger cached
+     * under the current generation.
+     */
+    static Logger& resolve(SiteCache& cache, const char* name)
+    {
+        State& state = get_state();
+        const uint64_t generation = state.generation.load(std::memory_order_acquire);
+        if (cache.generation.load(std::memory_order_acquire) == generation) {
+            return *cache.logger.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto it = state.loggers.find(name);
+        Logger& logger = (it != state.loggers.end()) ? *it->second : Logger::get_instance();
+        cache.logger.store(&logger, std::memory_order_relaxed);
+        cache.generation.store(state.generation.load(std::memory_order_relaxed), std::memory_order_release);
+        return logger;
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<Logger>> loggers;
+        std::atomic<uint64_t> generation{1};    // Bumped on every change; 0 marks an empty SiteCache
+    };
+
+    static State& get_state()
+    {
+        static State state;
+        return state;
+    }
+};
+
+} // namespace KL
+
+#endif //! REGISTRY_H
\ No newline at end of file
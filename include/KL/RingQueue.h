@@ -0,0 +1,173 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include <atomic>           // For std::atomic
+#include <memory>           // For std::unique_ptr
+#include <cstddef>          // For size_t
+#include <cstdint>          // For intptr_t
+#include <utility>          // For std::move
+
+namespace KL {
+
+/**
+ * @class RingQueue
+ * @brief Bounded lock-free multi-producer / single-consumer queue.
+ *
+ * Fixed array of slots, each with a sequence number (Dmitry Vyukov's bounded queue).
+ * Producers claim a position with one CAS on the tail and publish the slot by storing
+ * its sequence; the single consumer reads entries in place and releases them.
+ *
+ * Because every slot's state is carried by its sequence number, the queue can also be
+ * inspected without any lock (see for_each_pending()), which the crash handler relies on.
+ *
+ * @tparam T Default-constructible, move-assignable element type.
+ */
+template <typename T>
+class RingQueue {
+public:
+    RingQueue() = default;
+
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    /**
+     * @brief Allocates the slots. Must be called once, before any push/pop.
+     * @param capacity Requested number of slots (rounded up to a power of two, minimum 2).
+     */
+    void allocate(size_t capacity)
+    {
+        const size_t rounded = rounded_capacity(capacity);
+
+        mSlots.reset(new Slot[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mMask = rounded - 1;
+        mHead.store(0, std::memory_order_relaxed);
+        mTail.store(0, std::memory_order_release);
+    }
+
+    /// True once allocate() has been called
+    bool is_allocated() const noexcept { return mSlots != nullptr; }
+
+    /// Number of slots
+    size_t capacity() const noexcept { return mMask + 1; }
+
+    /// Number of slots allocate(capacity) creates
+    static size_t rounded_capacity(size_t capacity) noexcept
+    {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    /**
+     * @brief Producer side: moves value into the queue.
+     * @return false if the queue is full (value is left untouched).
+     */
+    bool try_push(T&& value)
+    {
+        size_t pos = mTail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        while (true) {
+            slot = &mSlots[pos & mMask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side: oldest published entry, or nullptr if empty. Valid until pop().
+    T* front() noexcept
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        Slot& slot = mSlots[head & mMask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return nullptr;
+        }
+        return &slot.value;
+    }
+
+    /// Consumer side: releases the entry returned by front(). Its resources are freed here, on the consumer.
+    void pop()
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        Slot& slot = mSlots[head & mMask];
+        slot.value = T{};
+        slot.sequence.store(head + mMask + 1, std::memory_order_release);
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    /// True when no entry is waiting (exact for the consumer, a hint for others)
+    bool empty() const noexcept
+    {
+        const size_t head = mHead.load(std::memory_order_acquire);
+        return mSlots[head & mMask].sequence.load(std::memory_order_acquire) != head + 1;
+    }
+
+    /// Approximate number of claimed-but-unconsumed slots
+    size_t size() const noexcept
+    {
+        const size_t tail = mTail.load(std::memory_order_acquire);
+        const size_t head = mHead.load(std::memory_order_acquire);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    /**
+     * @brief Visits every published, unconsumed entry from oldest to newest without locking.
+     *
+     * Only atomic loads and plain reads are performed, so this may be called from a signal
+     * handler. Slots still being written by a producer are skipped. The result is a
+     * best-effort snapshot if other threads keep running.
+     */
+    template <typename Fn>
+    void for_each_pending(Fn&& fn) const noexcept
+    {
+        if (!mSlots) {
+            return;
+        }
+
+        const size_t head = mHead.load(std::memory_order_acquire);
+        const size_t tail = mTail.load(std::memory_order_acquire);
+        for (size_t pos = head; pos != tail && pos - head <= mMask; ++pos) {
+            const Slot& slot = mSlots[pos & mMask];
+            if (slot.sequence.load(std::memory_order_acquire) == pos + 1) {
+                fn(slot.value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> mSlots;
+    size_t mMask{0};
+
+    alignas(64) std::atomic<size_t> mTail{0};   // Next position to claim (producers)
+    alignas(64) std::atomic<size_t> mHead{0};   // Next position to consume (worker)
+};
+
+} // namespace KL
+
+#endif //! RINGQUEUE_H
\ No newline at end of file
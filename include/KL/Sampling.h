@@ -0,0 +1,73 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <cstdint>          // For uint32_t, uint64_t
+#include <chrono>           // For the seed
+
+#include "ThreadInfo.h"
+
+namespace KL {
+
+/**
+ * @brief Per-thread random sampling decisions for the *_SAMPLED macros.
+ *
+ * Each thread owns a xorshift64* generator in a constant-initialized thread_local (no TLS
+ * guard), seeded on first use from its thread id and the clock. A decision is one TLS load, three
+ * shifts/xors, two multiplies and a compare: no division, no shared state, no atomics.
+ * Every kept line stands for `rate` lines, so counts scale back up by the rate printed on it.
+ */
+namespace Sampling {
+
+    namespace detail {
+        inline thread_local uint64_t tState = 0;    // 0 = not seeded yet
+
+        /// splitmix64 finalizer: turns any seed (even a small integer) into a well-mixed state
+        constexpr uint64_t mix(uint64_t x) noexcept
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        /// Slow path: runs once per thread
+        inline uint64_t seed() noexcept
+        {
+            const uint64_t now = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            const uint64_t state = mix(now ^ (static_cast<uint64_t>(ThreadInfo::current_id()) << 40));
+            tState = (state != 0) ? state : 1;
+            return tState;
+        }
+    }
+
+    /// Next 64-bit value of the calling thread's generator
+    inline uint64_t next() noexcept
+    {
+        uint64_t x = detail::tState;
+        if (x == 0) {
+            x = detail::seed();
+        }
+        x ^= x >> 12;
+        x ^= x << 25;
+        x ^= x >> 27;
+        detail::tState = x;
+        return x * 0x2545F4914F6CDD1Dull;
+    }
+
+    /**
+     * @brief true with probability 1/rate (rate 0 or 1: always).
+     *
+     * Maps the top 32 random bits onto [0, rate) with a multiply and shift instead of `%`.
+     */
+    inline bool keep(uint32_t rate) noexcept
+    {
+        if (rate <= 1) {
+            return true;
+        }
+        return ((next() >> 32) * rate >> 32) == 0;
+    }
+}
+
+} // namespace KL
+
+#endif //! SAMPLING_H
\ No newline at end of file
@@ -0,0 +1,241 @@
+#ifndef SANITIZER_H
+#define SANITIZER_H
+
+#include <string>           // For std::string
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint32_t
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define KL_SANITIZER_X86 1
+    #include <immintrin.h>  // SSE2 / AVX2 intrinsics
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h> // __cpuid, _BitScanForward
+        #define KL_TARGET_AVX2
+    #else
+        #define KL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define KL_SANITIZER_X86 0
+#endif
+
+namespace KL {
+
+/**
+ * @brief Escaping of control characters and invalid UTF-8 in log messages.
+ *
+ * A raw newline inside a message breaks the one-entry-per-line layout the file sink
+ * relies on for rotation, and a raw ESC byte can hijack the terminal's colors. The
+ * sanitizer rewrites such bytes as visible escapes (`\n`, `\t`, `\x1b`, ...) while
+ * passing valid multi-byte UTF-8 through untouched.
+ *
+ * Almost every message is plain printable ASCII, so the first step is a vectorized scan
+ * for the first byte outside [0x20, 0x7E]. The scan implementation (AVX2, SSE2 or scalar)
+ * is picked once at runtime from the CPU's feature flags.
+ */
+namespace Sanitizer {
+
+    /// Signature shared by every scan implementation: index of first unsafe byte, or size.
+    using ScanFn = size_t (*)(const char* data, size_t size) noexcept;
+
+    /// Byte-at-a-time reference scan. Used for tails and on non-x86 targets.
+    inline size_t scan_scalar(const char* data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; ++i) {
+            const auto c = static_cast<unsigned char>(data[i]);
+            if (c < 0x20 || c > 0x7E) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+#if KL_SANITIZER_X86
+    namespace detail {
+        /// Index of the lowest set bit (mask is never zero here)
+        inline unsigned lowest_bit(uint32_t mask) noexcept
+        {
+            #if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index = 0;
+                _BitScanForward(&index, mask);
+                return static_cast<unsigned>(index);
+            #else
+                return static_cast<unsigned>(__builtin_ctz(mask));
+            #endif
+        }
+    }
+
+    /// 16 bytes per step. Signed compare: bytes >= 0x80 are negative and fail the lower bound.
+    inline size_t scan_sse2(const char* data, size_t size) noexcept
+    {
+        const __m128i lower = _mm_set1_epi8(0x1F);
+        const __m128i upper = _mm_set1_epi8(0x7F);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i ok = _mm_and_si128(_mm_cmpgt_epi8(v, lower), _mm_cmplt_epi8(v, upper));
+            const uint32_t bad = ~static_cast<uint32_t>(_mm_movemask_epi8(ok)) & 0xFFFFu;
+            if (bad) {
+                return i + detail::lowest_bit(bad);
+            }
+        }
+        return i + scan_scalar(data + i, size - i);
+    }
+
+    /// 32 bytes per step, same predicate as scan_sse2().
+    KL_TARGET_AVX2 inline size_t scan_avx2(const char* data, size_t size) noexcept
+    {
+        const __m256i lower = _mm256_set1_epi8(0x1F);
+        const __m256i upper = _mm256_set1_epi8(0x7F);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const __m256i ok = _mm256_and_si256(_mm256_cmpgt_epi8(v, lower), _mm256_cmpgt_epi8(upper, v));
+            const uint32_t bad = ~static_cast<uint32_t>(_mm256_movemask_epi8(ok));
+            if (bad) {
+                return i + detail::lowest_bit(bad);
+            }
+        }
+        return i + scan_sse2(data + i, size - i);
+    }
+
+    /// Checks CPUID (and OS support for YMM state) for AVX2
+    inline bool cpu_has_avx2() noexcept
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            int regs[4]{};
+            __cpuid(regs, 1);
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const bool avx     = (regs[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(regs, 7, 0);
+            return (regs[1] & (1 << 5)) != 0;
+        #else
+            return __builtin_cpu_supports("avx2");
+        #endif
+    }
+#endif
+
+    /// Picks the widest scan implementation supported by the running CPU
+    inline ScanFn select_scan() noexcept
+    {
+        #if KL_SANITIZER_X86
+            if (cpu_has_avx2()) {
+                return &scan_avx2;
+            }
+            return &scan_sse2;
+        #else
+            return &scan_scalar;
+        #endif
+    }
+
+    /// Returns the index of the first byte that needs attention, or size if the input is clean ASCII
+    inline size_t scan(const char* data, size_t size) noexcept
+    {
+        static const ScanFn fn = select_scan();
+        return fn(data, size);
+    }
+
+    /**
+     * @brief Length of the well-formed UTF-8 sequence starting at data, or 0 if it is invalid.
+     *
+     * Rejects overlong encodings, UTF-16 surrogates and code points above U+10FFFF.
+     */
+    inline size_t utf8_sequence_length(const char* data, size_t size) noexcept
+    {
+        const auto* s = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char lead = s[0];
+
+        size_t length = 0;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF)      { length = 2; }
+        else if (lead == 0xE0)                 { length = 3; lo = 0xA0; }
+        else if (lead == 0xED)                 { length = 3; hi = 0x9F; }
+        else if (lead >= 0xE1 && lead <= 0xEF) { length = 3; }
+        else if (lead == 0xF0)                 { length = 4; lo = 0x90; }
+        else if (lead == 0xF4)                 { length = 4; hi = 0x8F; }
+        else if (lead >= 0xF1 && lead <= 0xF3) { length = 4; }
+        else                                   { return 0; }
+
+        if (size < length || s[1] < lo || s[1] > hi) {
+            return 0;
+        }
+        for (size_t i = 2; i < length; ++i) {
+            if (s[i] < 0x80 || s[i] > 0xBF) {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    /// Appends the escaped form of a single control or invalid byte
+    inline void append_escape(std::string& out, unsigned char c)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        switch (c) {
+            case '\n': out += "\\n"; return;
+            case '\r': out += "\\r"; return;
+            case '\t': out += "\\t"; return;
+            default:
+                break;
+        }
+
+        const char escaped[4] = { '\\', 'x', hex[c >> 4], hex[c & 0x0F] };
+        out.append(escaped, sizeof(escaped));
+    }
+
+    /**
+     * @brief Appends data to out with control characters and invalid UTF-8 escaped.
+     *
+     * @param out  Destination buffer (appended to, never cleared)
+     * @param data Message bytes
+     * @param size Number of bytes
+     * @return true if the message was clean ASCII and copied verbatim.
+     */
+    inline bool append_sanitized(std::string& out, const char* data, size_t size)
+    {
+        size_t pos = scan(data, size);
+        if (pos == size) {
+            out.append(data, size);
+            return true;
+        }
+
+        size_t start = 0;
+        while (pos < size) {
+            out.append(data + start, pos - start);
+
+            const auto c = static_cast<unsigned char>(data[pos]);
+            const size_t utf8 = (c >= 0x80) ? utf8_sequence_length(data + pos, size - pos) : 0;
+            if (utf8 != 0) {
+                out.append(data + pos, utf8);
+                pos += utf8;
+            }
+            else {
+                append_escape(out, c);
+                ++pos;
+            }
+
+            start = pos;
+            pos += scan(data + pos, size - pos);
+        }
+
+        out.append(data + start, size - start);
+        return false;
+    }
+
+    /// Convenience overload for std::string messages
+    inline bool append_sanitized(std::string& out, const std::string& msg)
+    {
+        return append_sanitized(out, msg.data(), msg.size());
+    }
+
+} // namespace Sanitizer
+} // namespace KL
+
+#endif //! SANITIZER_H
\ No newline at end of file
@@ -0,0 +1,433 @@
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#ifndef _WIN32
+
+#include <atomic>           // For std::atomic
+#include <string>           // For std::string
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint32_t, uint64_t, int64_t
+#include <cstring>          // For std::memcpy, std::memset
+#include <cerrno>           // For errno, ESRCH, EBUSY
+#include <new>              // For placement new
+
+#include <fcntl.h>          // O_* flags
+#include <sys/mman.h>       // shm_open, mmap, munmap, shm_unlink
+#include <sys/stat.h>       // fstat
+#include <signal.h>         // kill
+#include <unistd.h>         // ftruncate, getpid, close
+
+#include "Level.h"
+
+namespace KL {
+
+/**
+ * @class ShmRing
+ * @brief Log record ring in a named POSIX shared-memory segment, drained by an external process.
+ *
+ * Producers (the logging threads) copy records straight into the segment, so entries survive
+ * even if the process is SIGKILLed before any of its own threads write them out. The
+ * `kl-collector` tool attaches to the segment and writes the records to disk.
+ *
+ * Segment layout (version 1, all integers little-endian / native):
+ * @code
+ *   offset  size  field
+ *   0       8     magic            "KLOGSHM1"
+ *   8       4     version          1
+ *   12      4     headerSize       offset of the data area (256)
+ *   16      8     capacity         data area size in bytes (power of two)
+ *   24      4     producerPid      pid of the creating process
+ *   28      4     flags            bit 0: producer closed the ring cleanly
+ *   64      8     writePos         bytes ever reserved by producers (atomic)
+ *   128     8     readPos          bytes ever consumed by the collector (atomic)
+ *   192     8     dropped          records discarded because the ring was full (atomic)
+ *   256     ...   data[capacity]
+ * @endcode
+ *
+ * Records start at data[pos % capacity], are 8-byte aligned and never wrap; when a record does
+ * not fit before the end of the data area the producer first places a padding record there.
+ * @code
+ *   0       4     state            size | 1 (committed) | 2 (padding); size is a multiple of 8
+ *   4       1     level            KL::Level value
+ *   5       3     reserved
+ *   8       4     threadId         KL::ThreadInfo id of the producing thread
+ *   12      4     messageLength    bytes of message text that follow the header
+ *   16      8     timestamp        nanoseconds since the Unix epoch (system clock)
+ *   24      ...   message          UTF-8 text, not NUL-terminated
+ * @endcode
+ *
+ * Protocol: a producer reserves space with a CAS on writePos, stores `state = size` (not yet
+ * committed), copies the record, then publishes it by storing `state | 1` with release order.
+ * The collector consumes committed records in order, zeroes them and advances readPos. A
+ * record that never gets committed because its producer died can be skipped using its size;
+ * one whose producer died before even storing the size is still all zeros (consumed space is
+ * zeroed), so it ends at the next non-zero state word or at writePos.
+ */
+class ShmRing {
+public:
+    static constexpr uint64_t kMagic = 0x314D4853474F4C4BULL;  // "KLOGSHM1"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 256;
+    static constexpr size_t kRecordHeaderSize = 24;
+
+    static constexpr uint32_t kCommitted = 1;
+    static constexpr uint32_t kPadding = 2;
+    static constexpr uint32_t kFlagClosed = 1;
+
+    /// Shared header, placed at offset 0 of the segment
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t capacity;
+        uint32_t producerPid;
+        std::atomic<uint32_t> flags;
+        alignas(64) std::atomic<uint64_t> writePos;
+        alignas(64) std::atomic<uint64_t> readPos;
+        alignas(64) std::atomic<uint64_t> dropped;
+    };
+
+    /// Decoded view of one record (collector side); message points into the segment
+    struct Record {
+        Level level;
+        uint32_t threadId;
+        int64_t timestampNanos;
+        const char* message;
+        size_t messageLength;
+    };
+
+    static_assert(sizeof(Header) <= kHeaderSize, "ShmRing header must fit in kHeaderSize");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+                  "Shared-memory atomics must be lock-free (address-free)");
+
+    ShmRing() = default;
+    ~ShmRing() { close(); }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * @brief Producer side: creates (replacing a drained stale segment of the same name) and maps the ring.
+     *
+     * A segment that still holds undrained records, or whose producer is still running, is
+     * left alone: create() then fails with errno = EBUSY so those records can still be collected.
+     *
+     * @param name     Segment name, e.g. "/myapp.klog"
+     * @param capacity Data area size (rounded up to a power of two, minimum 64 KiB)
+     * @return false on failure (errno is preserved).
+     */
+    bool create(const std::string& name, size_t capacity)
+    {
+        size_t rounded = 64 * 1024;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+
+        if (in_use(name)) {
+            errno = EBUSY;
+            return false;
+        }
+
+        // A previous run's segment may still be mapped by its collector: unlinking leaves that mapping alone
+        shm_unlink(name.c_str());
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(kHeaderSize + rounded)) != 0 || !remember_identity(fd) || !map(fd, kHeaderSize + rounded)) {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+        ::close(fd);
+
+        auto* header = new (mBase) Header{};
+        header->magic = kMagic;
+        header->version = kVersion;
+        header->headerSize = static_cast<uint32_t>(kHeaderSize);
+        header->capacity = rounded;
+        header->producerPid = static_cast<uint32_t>(getpid());
+        header->flags.store(0, std::memory_order_relaxed);
+        header->writePos.store(0, std::memory_order_relaxed);
+        header->readPos.store(0, std::memory_order_relaxed);
+        header->dropped.store(0, std::memory_order_release);
+
+        mName = name;
+        return true;
+    }
+
+    /**
+     * @brief Collector side: maps an existing ring.
+     * @return false if the segment does not exist or is not a compatible kLogger ring.
+     */
+    bool attach(const std::string& name)
+    {
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kHeaderSize || !map(fd, static_cast<size_t>(info.st_size))) {
+            ::close(fd);
+            return false;
+        }
+        ::close(fd);
+        mDevice = info.st_dev;
+        mInode = info.st_ino;
+
+        if (header()->magic != kMagic || header()->version != kVersion
+            || header()->headerSize != kHeaderSize || kHeaderSize + header()->capacity > mSize) {
+            close();
+            return false;
+        }
+
+        mName = name;
+        return true;
+    }
+
+    /// True while a segment is mapped
+    bool is_open() const noexcept { return mBase != nullptr; }
+
+    /// Shared header (valid while is_open())
+    Header* header() const noexcept { return static_cast<Header*>(mBase); }
+
+    /**
+     * @brief Producer side: copies one record into the ring. Lock-free; never blocks.
+     * @return false if the ring is full (the drop counter in the header is incremented).
+     */
+    bool try_write(Level level, uint32_t threadId, int64_t timestampNanos, const char* message, size_t length) noexcept
+    {
+        Header* h = header();
+        const uint64_t capacity = h->capacity;
+
+        if (length > capacity / 2) {
+            length = static_cast<size_t>(capacity / 2);  // Keep oversized messages from starving the ring
+        }
+        const uint64_t size = (kRecordHeaderSize + length + 7) & ~uint64_t{7};
+
+        uint64_t pos = h->writePos.load(std::memory_order_relaxed);
+        uint64_t padding = 0;
+        while (true) {
+            const uint64_t offset = pos & (capacity - 1);
+            padding = (offset + size > capacity) ? capacity - offset : 0;
+
+            const uint64_t read = h->readPos.load(std::memory_order_acquire);
+            if (pos + padding + size - read > capacity) {
+                h->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (h->writePos.compare_exchange_weak(pos, pos + padding + size, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (padding != 0) {
+            state_at(pos).store(static_cast<uint32_t>(padding) | kPadding | kCommitted, std::memory_order_release);
+            pos += padding;
+        }
+
+        char* record = data() + (pos & (capacity - 1));
+        auto& state = state_at(pos);
+        state.store(static_cast<uint32_t>(size), std::memory_order_relaxed);  // Size first: lets a torn record be skipped
+
+        const auto levelByte = static_cast<uint8_t>(level);
+        const auto messageLength = static_cast<uint32_t>(length);
+        std::memcpy(record + 4, &levelByte, 1);
+        std::memcpy(record + 8, &threadId, 4);
+        std::memcpy(record + 12, &messageLength, 4);
+        std::memcpy(record + 16, &timestampNanos, 8);
+        std::memcpy(record + kRecordHeaderSize, message, length);
+
+        state.store(static_cast<uint32_t>(size) | kCommitted, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Collector side: hands committed records to fn in order and frees their space.
+     *
+     * @param fn         Called as fn(const Record&)
+     * @param maxRecords Upper bound for this call
+     * @param skipTorn   Skip a reserved-but-uncommitted record at the head (use only once its producer is dead)
+     * @return Number of records delivered.
+     */
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t maxRecords, bool skipTorn = false)
+    {
+        Header* h = header();
+        const uint64_t capacity = h->capacity;
+        uint64_t read = h->readPos.load(std::memory_order_relaxed);
+        size_t delivered = 0;
+
+        while (delivered < maxRecords && read < h->writePos.load(std::memory_order_acquire)) {
+            const uint32_t state = state_at(read).load(std::memory_order_acquire);
+            const uint64_t size = state & ~uint32_t{7};
+
+            if (size == 0 && skipTorn) {
+                // Reserved, then its producer died before sizing it: step over the zeros
+                read = unsized_end(read, h->writePos.load(std::memory_order_acquire));
+                h->readPos.store(read, std::memory_order_release);
+                continue;
+            }
+            if (size == 0 || size > capacity) {
+                break;                              // Reserved but not even sized yet
+            }
+            if (!(state & kCommitted) && !skipTorn) {
+                break;                              // Still being written
+            }
+
+            char* record = data() + (read & (capacity - 1));
+            if ((state & kCommitted) && !(state & kPadding)) {
+                uint8_t levelByte = 0;
+                uint32_t messageLength = 0;
+                Record view{};
+                std::memcpy(&levelByte, record + 4, 1);
+                std::memcpy(&view.threadId, record + 8, 4);
+                std::memcpy(&messageLength, record + 12, 4);
+                std::memcpy(&view.timestampNanos, record + 16, 8);
+                view.level = static_cast<Level>(levelByte);
+                view.message = record + kRecordHeaderSize;
+                view.messageLength = (messageLength <= size - kRecordHeaderSize) ? messageLength : 0;
+                fn(static_cast<const Record&>(view));
+                ++delivered;
+            }
+
+            std::memset(record, 0, static_cast<size_t>(size));   // Next writer must find state == 0
+            read += size;
+            h->readPos.store(read, std::memory_order_release);
+        }
+        return delivered;
+    }
+
+    /// True if the producer process recorded in the header no longer exists
+    bool producer_gone() const noexcept
+    {
+        const auto pid = static_cast<pid_t>(header()->producerPid);
+        return (header()->flags.load(std::memory_order_acquire) & kFlagClosed)
+            || (kill(pid, 0) != 0 && errno == ESRCH);
+    }
+
+    /// Producer side: marks the ring as cleanly closed (the collector may exit once drained)
+    void mark_closed() noexcept
+    {
+        if (mBase != nullptr) {
+            header()->flags.fetch_or(kFlagClosed, std::memory_order_release);
+        }
+    }
+
+    /// Unmaps the segment; the name stays until unlink() so a collector can still attach
+    void close() noexcept
+    {
+        if (mBase != nullptr) {
+            munmap(mBase, mSize);
+            mBase = nullptr;
+            mSize = 0;
+        }
+    }
+
+    /// Removes the segment name
+    static void unlink(const std::string& name) noexcept
+    {
+        shm_unlink(name.c_str());
+    }
+
+    /**
+     * @brief Removes the segment name, but only while it still refers to the segment this object mapped.
+     *
+     * A producer restarted under the same name has created a new segment by then; that one is kept.
+     * @return true if the name was removed.
+     */
+    bool unlink_if_same() const noexcept
+    {
+        const int fd = shm_open(mName.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info{};
+        const bool same = fstat(fd, &info) == 0 && info.st_dev == mDevice && info.st_ino == mInode;
+        ::close(fd);
+        return same && shm_unlink(mName.c_str()) == 0;
+    }
+
+    const std::string& name() const noexcept { return mName; }
+
+private:
+    bool map(int fd, size_t size)
+    {
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        mBase = base;
+        mSize = size;
+        return true;
+    }
+
+    char* data() const noexcept { return static_cast<char*>(mBase) + kHeaderSize; }
+
+    bool remember_identity(int fd) noexcept
+    {
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            return false;
+        }
+        mDevice = info.st_dev;
+        mInode = info.st_ino;
+        return true;
+    }
+
+    /// True if name is a kLogger ring with records no collector has drained yet, or a live producer
+    static bool in_use(const std::string& name) noexcept
+    {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info{};
+        void* base = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kHeaderSize) {
+            base = mmap(nullptr, kHeaderSize, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+
+        const auto* h = static_cast<const Header*>(base);
+        bool busy = false;
+        if (h->magic == kMagic && h->version == kVersion) {
+            const bool closed = (h->flags.load(std::memory_order_acquire) & kFlagClosed) != 0;
+            const auto pid = static_cast<pid_t>(h->producerPid);
+            const bool producerAlive = !closed && pid != getpid() && (kill(pid, 0) == 0 || errno != ESRCH);
+            busy = producerAlive || h->readPos.load(std::memory_order_acquire) < h->writePos.load(std::memory_order_acquire);
+        }
+        munmap(base, kHeaderSize);
+        return busy;
+    }
+
+    /// End of the unsized reservations starting at pos: the next record with a state, or end
+    uint64_t unsized_end(uint64_t pos, uint64_t end) const noexcept
+    {
+        while (pos < end && state_at(pos).load(std::memory_order_acquire) == 0) {
+            pos += 8;
+        }
+        return pos;
+    }
+
+    std::atomic<uint32_t>& state_at(uint64_t pos) const noexcept
+    {
+        return *reinterpret_cast<std::atomic<uint32_t>*>(data() + (pos & (header()->capacity - 1)));
+    }
+
+    void* mBase{nullptr};
+    size_t mSize{0};
+    std::string mName;
+    dev_t mDevice{0};       // Identity of the mapped segment (see unlink_if_same())
+    ino_t mInode{0};
+};
+
+} // namespace KL
+
+#endif // !_WIN32
+
+#endif //! SHMRING_H
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SOURCESITE_H
+#define SOURCESITE_H
+
+#include "Level.h"
+
+/**
+ * @brief Set to 1 to record only the file name (no directories) in SourceSite::file.
+ *
+ * Resolved at compile time: with GCC 12+ / Clang 9+ the compiler's own `__FILE_NAME__`
+ * is used so the full path never reaches the binary; otherwise the basename is computed
+ * by a constexpr function inside the static initializer.
+ */
+#ifndef KL_STRIP_SOURCE_PATH
+    #define KL_STRIP_SOURCE_PATH 0
+#endif
+
+#if KL_STRIP_SOURCE_PATH
+    #if defined(__FILE_NAME__)
+        #define KL_SOURCE_FILE __FILE_NAME__
+    #else
+        #define KL_SOURCE_FILE ::KL::detail::source_basename(__FILE__)
+    #endif
+#else
+    #define KL_SOURCE_FILE __FILE__
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define KL_SOURCE_FUNCTION __FUNCTION__
+#else
+    #define KL_SOURCE_FUNCTION __func__
+#endif
+
+namespace KL {
+    /**
+     * @brief Compile-time description of one logging call site.
+     *
+     * Every LOG_ / FLOG_ macro expansion defines one of these as a function-local
+     * `static constexpr`, so it lives in read-only data and is never constructed at runtime.
+     * Only its address travels through the queue with the LogEntry; the address is also a
+     * stable identifier for the call site for the lifetime of the process.
+     */
+    struct SourceSite {
+        const char* file;       ///< __FILE__ (or its basename, see KL_STRIP_SOURCE_PATH)
+        int line;               ///< __LINE__
+        const char* function;   ///< Enclosing function name
+        Level level;            ///< Level the macro logs at
+        const char* format;     ///< Message expression as written at the call site
+    };
+
+    namespace detail {
+        /// Returns a pointer to the character after the last path separator
+        constexpr const char* source_basename(const char* path) noexcept
+        {
+            const char* base = path;
+            for (const char* p = path; *p != '\0'; ++p) {
+                if (*p == '/' || *p == '\\') {
+                    base = p + 1;
+                }
+            }
+            return base;
+        }
+    }
+}
+
+#endif //! SOURCESITE_H
\ No newline at end of file
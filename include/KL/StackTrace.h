@@ -0,0 +1,119 @@
+#ifndef STACKTRACE_H
+#define STACKTRACE_H
+
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uintptr_t
+
+#include "CrashHandler.h"
+
+#if defined(__has_include)
+    #if __has_include(<execinfo.h>)
+        #include <execinfo.h>   // backtrace, backtrace_symbols_fd
+        #define KL_HAS_EXECINFO 1
+    #endif
+#endif
+#ifndef KL_HAS_EXECINFO
+    #define KL_HAS_EXECINFO 0
+#endif
+
+namespace KL {
+
+/**
+ * @brief Signal-safe stack trace capture for the crash handler.
+ *
+ * Frames are collected into a caller-provided array (no allocation). Where glibc's
+ * <execinfo.h> is available the unwinder is used and frames are printed with
+ * backtrace_symbols_fd(), which writes "module(symbol+offset) [address]" straight to a
+ * descriptor without calling malloc; static functions show up as module+offset, ready for
+ * offline symbolization (`addr2line -e <module> <offset>`). Elsewhere the trace falls back to
+ * walking frame pointers (accurate only with -fno-omit-frame-pointer) and prints raw addresses.
+ */
+namespace StackTrace {
+
+    /// Maximum frames captured by the crash handler
+    inline constexpr int kMaxFrames = 64;
+
+    /**
+     * @brief Loads the unwinder ahead of time.
+     *
+     * The first backtrace() call dlopen()s libgcc_s, which allocates; doing it once at init
+     * keeps the call inside the signal handler allocation-free.
+     */
+    inline void prepare() noexcept
+    {
+        #if KL_HAS_EXECINFO
+            void* frames[2];
+            backtrace(frames, 2);
+        #endif
+    }
+
+    /**
+     * @brief Captures the current call stack.
+     * @param frames    Destination array
+     * @param maxFrames Capacity of frames
+     * @return Number of frames stored.
+     */
+    inline int capture(void** frames, int maxFrames) noexcept
+    {
+        #if KL_HAS_EXECINFO
+            return backtrace(frames, maxFrames);
+        #elif defined(__GNUC__) || defined(__clang__)
+            // Frame-pointer walk: [fp] = caller's fp, [fp + 1] = return address
+            int count = 0;
+            auto** fp = static_cast<void**>(__builtin_frame_address(0));
+            while (fp != nullptr && count < maxFrames) {
+                void* returnAddress = fp[1];
+                if (returnAddress == nullptr) {
+                    break;
+                }
+                frames[count++] = returnAddress;
+
+                auto** next = static_cast<void**>(fp[0]);
+                // Stacks grow down: a sane caller frame is above ours and not absurdly far away
+                if (next <= fp || reinterpret_cast<uintptr_t>(next) - reinterpret_cast<uintptr_t>(fp) > (1u << 24)) {
+                    break;
+                }
+                fp = next;
+            }
+            return count;
+        #else
+            (void)frames;
+            (void)maxFrames;
+            return 0;
+        #endif
+    }
+
+    /**
+     * @brief Writes captured frames to fd, one per line. Async-signal-safe (no allocation).
+     */
+    inline void write(int fd, void* const* frames, int count) noexcept
+    {
+        if (fd < 0 || count <= 0) {
+            return;
+        }
+
+        {
+            Crash::SafeWriter out(fd);
+            out.append("[kLogger] stack trace (");
+            out.append_uint(static_cast<uint64_t>(count));
+            out.append(" frames):\n");
+        }
+
+        #if KL_HAS_EXECINFO
+            backtrace_symbols_fd(frames, count, fd);
+        #else
+            Crash::SafeWriter out(fd);
+            for (int i = 0; i < count; ++i) {
+                out.append("  #");
+                out.append_uint(static_cast<uint64_t>(i));
+                out.append_char(' ');
+                out.append_hex(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i])));
+                out.append_char('\n');
+            }
+        #endif
+    }
+}
+
+} // namespace KL
+
+#endif //! STACKTRACE_H
\ No newline at end of file
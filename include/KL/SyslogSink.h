@@ -0,0 +1,455 @@
+#ifndef SYSLOGSINK_H
+#define SYSLOGSINK_H
+
+#ifndef _WIN32
+
+#include <array>            // For std::array
+#include <atomic>           // For std::atomic
+#include <chrono>           // For timestamps and the reconnect back-off
+#include <cerrno>           // For errno
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint32_t, uint64_t
+#include <cstring>          // For std::memcpy, std::strlen
+#include <ctime>            // For gmtime_r
+#include <string>           // For std::string
+#include <string_view>      // For std::string_view
+#include <vector>           // For std::vector
+
+#include <fcntl.h>          // fcntl, FD_CLOEXEC
+#include <sys/socket.h>     // socket, connect, send, sendmmsg
+#include <sys/uio.h>        // iovec
+#include <sys/un.h>         // sockaddr_un
+#include <unistd.h>         // close, getpid, gethostname
+
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+    #include <stdlib.h>     // getprogname
+#endif
+
+#include "Config.h"
+#include "Format.h"
+#include "Level.h"
+#include "Sanitizer.h"
+#include "SourceSite.h"
+
+namespace KL {
+
+/**
+ * @class SyslogSink
+ * @brief Forwards entries to the host log over a local Unix datagram socket (Config::syslogProtocol).
+ *
+ * One datagram per entry, in either format:
+ *   - SyslogProtocol::Rfc5424 (/dev/log): `<PRI>1 TIMESTAMP HOST APP PID - - MSG`, with the
+ *     entry's time in UTC and PRI = facility * 8 + severity
+ *   - SyslogProtocol::Journald (/run/systemd/journal/socket): the native KEY=VALUE protocol
+ *     with PRIORITY, SYSLOG_IDENTIFIER, SYSLOG_FACILITY, SYSLOG_PID, KL_THREAD and, for macro
+ *     call sites, CODE_FILE / CODE_LINE / CODE_FUNC; multi-line messages use the
+ *     length-prefixed MESSAGE field
+ *
+ * KL::Level maps to the syslog severities 6 (INFO), 4 (WARNING) and 3 (ERROR).
+ *
+ * The worker appends the datagrams of a batch to one buffer and sends them with a single
+ * sendmmsg() (one send() each where sendmmsg is not available). Sends never block: when the
+ * socket buffer is full, or the listener is gone, the rest of the batch is dropped and counted
+ * (dropped()). On Linux the listener's queue holds net.unix.max_dgram_qlen datagrams (10 by
+ * default, 512 where systemd sets it), so a burst that outruns the listener loses its tail
+ * rather than stalling the worker. A lost listener is reconnected at most once per second, so
+ * journald or rsyslog can restart underneath the process. Datagrams larger than the socket
+ * allows are dropped too.
+ *
+ * Used by the worker thread only; sent() and dropped() may be read from any thread.
+ */
+class SyslogSink {
+public:
+    static constexpr const char* kSyslogSocket = "/dev/log";
+    static constexpr const char* kJournaldSocket = "/run/systemd/journal/socket";
+
+    /// Datagrams per sendmmsg(); a batch with more is sent in several calls
+    static constexpr size_t kMaxBatch = 64;
+
+    SyslogSink() = default;
+    ~SyslogSink() { close(); }
+
+    SyslogSink(const SyslogSink&) = delete;
+    SyslogSink& operator=(const SyslogSink&) = delete;
+
+    /**
+     * @brief Creates the socket and connects it to socketPath (empty = the protocol's default).
+     *
+     * A listener that is not there yet is not an error: the sink retries once per second and
+     * counts what it could not send.
+     * @param identifier APP-NAME / SYSLOG_IDENTIFIER; empty = the program name
+     * @param facility   Syslog facility code (1 = user, 16..23 = local0..local7)
+     * @return false if the socket cannot be created (errno is preserved).
+     */
+    bool open(SyslogProtocol protocol, const std::string& socketPath, const std::string& identifier, int facility)
+    {
+        close();
+        if (protocol == SyslogProtocol::Off) {
+            return false;
+        }
+
+        const std::string path = !socketPath.empty() ? socketPath
+                               : (protocol == SyslogProtocol::Journald ? kJournaldSocket : kSyslogSocket);
+        if (path.size() >= sizeof(sockaddr_un::sun_path)) {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+
+        mFd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (mFd < 0) {
+            return false;
+        }
+        ::fcntl(mFd, F_SETFD, FD_CLOEXEC);
+
+        mAddress = sockaddr_un{};
+        mAddress.sun_family = AF_UNIX;
+        std::memcpy(mAddress.sun_path, path.c_str(), path.size() + 1);
+
+        mProtocol = protocol;
+        mFacility = (facility >= 0 && facility <= 23) ? facility : 1;
+        mPid = static_cast<uint32_t>(::getpid());
+        mIdentifier = make_identifier(identifier);
+        mHostname = make_hostname();
+
+        mBuffer.reserve(16 * 1024);
+        mEnds.reserve(kMaxBatch);
+        connect();
+        return true;
+    }
+
+    /// True between a successful open() and close()
+    bool is_open() const noexcept { return mFd >= 0; }
+
+    /// Whether the socket is currently connected to a listener
+    bool is_connected() const noexcept { return mConnected; }
+
+    /// Path the sink sends to (valid while is_open())
+    const char* path() const noexcept { return mAddress.sun_path; }
+
+    /**
+     * @brief Appends one entry's datagram to the pending batch; sends the batch first if it is full.
+     * @param sanitize Escape control characters and invalid UTF-8 (Config::sanitize)
+     */
+    void add(Level level, std::chrono::system_clock::time_point time, uint32_t threadId, const SourceSite* site,
+             const std::string& msg, bool sanitize)
+    {
+        if (mEnds.size() == kMaxBatch) {
+            flush();
+        }
+        if (mProtocol == SyslogProtocol::Journald) {
+            append_journald(level, threadId, site, msg, sanitize);
+        }
+        else {
+            append_rfc5424(level, time, msg, sanitize);
+        }
+        mEnds.push_back(mBuffer.size());
+    }
+
+    /// Sends the pending datagrams without blocking; whatever cannot be sent is dropped and counted
+    void flush() noexcept
+    {
+        if (mEnds.empty()) {
+            return;
+        }
+
+        const size_t count = mEnds.size();
+        size_t first = 0;
+        if (mConnected || connect()) {
+            first = send_all(count);
+        }
+
+        if (first < count) {
+            mDropped.fetch_add(count - first, std::memory_order_relaxed);
+        }
+        mBuffer.clear();
+        mEnds.clear();
+    }
+
+    /// Drops anything pending and closes the socket
+    void close() noexcept
+    {
+        if (mFd >= 0) {
+            ::close(mFd);
+            mFd = -1;
+        }
+        mConnected = false;
+        mBuffer.clear();
+        mEnds.clear();
+    }
+
+    /// Datagrams handed to the socket
+    uint64_t sent() const noexcept { return mSent.load(std::memory_order_relaxed); }
+
+    /// Datagrams dropped: full socket buffer, no listener, or too large
+    uint64_t dropped() const noexcept { return mDropped.load(std::memory_order_relaxed); }
+
+    /// Syslog severity of a level (RFC 5424 table 2)
+    static constexpr int severity(Level level) noexcept
+    {
+        switch (level) {
+            case Level::ERROR:   return 3;
+            case Level::WARNING: return 4;
+            case Level::INFO:
+            default:             return 6;
+        }
+    }
+
+private:
+    static constexpr std::chrono::seconds kReconnectInterval{1};
+
+    /// Connects the socket, at most once per kReconnectInterval after a failure
+    bool connect() noexcept
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (now < mNextConnect) {
+            return false;
+        }
+        mNextConnect = now + kReconnectInterval;
+
+        // A datagram socket may be reconnected; AF_UNSPEC first drops the old peer
+        sockaddr unspecified{};
+        unspecified.sa_family = AF_UNSPEC;
+        ::connect(mFd, &unspecified, sizeof(unspecified));
+
+        mConnected = ::connect(mFd, reinterpret_cast<const sockaddr*>(&mAddress), sizeof(mAddress)) == 0;
+        return mConnected;
+    }
+
+    /**
+     * @brief Sends the pending datagrams until done or the socket refuses one.
+     * @return How many were sent or dropped as too large; the rest is dropped by the caller.
+     */
+    size_t send_all(size_t count) noexcept
+    {
+        size_t first = 0;
+        while (first < count) {
+            const int error = send_from(first, count);
+            if (error == 0 || error == EINTR) {
+                continue;
+            }
+            if (error == EMSGSIZE) {
+                // Only this datagram is too large for the socket
+                ++first;
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (error != EAGAIN && error != EWOULDBLOCK && error != ENOBUFS) {
+                // ECONNREFUSED, ENOENT, ENOTCONN...: the listener went away
+                mConnected = false;
+            }
+            break;
+        }
+        return first;
+    }
+
+    /**
+     * @brief Sends datagrams [first, count) and advances first past those accepted.
+     * @return 0 after progress, otherwise the errno of the failed send.
+     */
+    int send_from(size_t& first, size_t count) noexcept
+    {
+        #if defined(__linux__)
+            const size_t batch = count - first;
+            for (size_t i = 0; i < batch; ++i) {
+                const size_t begin = (first + i == 0) ? 0 : mEnds[first + i - 1];
+                mIov[i].iov_base = mBuffer.data() + begin;
+                mIov[i].iov_len = mEnds[first + i] - begin;
+                mMessages[i] = mmsghdr{};
+                mMessages[i].msg_hdr.msg_iov = &mIov[i];
+                mMessages[i].msg_hdr.msg_iovlen = 1;
+            }
+            const int sent = ::sendmmsg(mFd, mMessages.data(), static_cast<unsigned>(batch), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent > 0) {
+                first += static_cast<size_t>(sent);
+                mSent.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+                return 0;
+            }
+            return (sent == 0) ? EAGAIN : errno;
+        #else
+            const size_t begin = (first == 0) ? 0 : mEnds[first - 1];
+            int flags = MSG_DONTWAIT;
+            #ifdef MSG_NOSIGNAL
+                flags |= MSG_NOSIGNAL;
+            #endif
+            if (::send(mFd, mBuffer.data() + begin, mEnds[first] - begin, flags) < 0) {
+                return errno;
+            }
+            ++first;
+            mSent.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        #endif
+    }
+
+    /// <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA MSG
+    void append_rfc5424(Level level, std::chrono::system_clock::time_point time, const std::string& msg, bool sanitize)
+    {
+        mBuffer += '<';
+        Format::append_uint(mBuffer, static_cast<uint64_t>(mFacility * 8 + severity(level)));
+        mBuffer += ">1 ";
+        append_timestamp(time);
+        mBuffer += ' ';
+        mBuffer += mHostname;
+        mBuffer += ' ';
+        mBuffer += mIdentifier;
+        mBuffer += ' ';
+        Format::append_uint(mBuffer, mPid);
+        mBuffer += " - - ";
+        append_message(msg, sanitize);
+    }
+
+    /// RFC 3339 in UTC with microseconds: 2026-01-31T23:59:59.123456Z
+    void append_timestamp(std::chrono::system_clock::time_point time)
+    {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+        const std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+        const unsigned fraction = static_cast<unsigned>(micros % 1000000);
+
+        std::tm utc{};
+        gmtime_r(&seconds, &utc);
+
+        char text[32];
+        const unsigned year = static_cast<unsigned>(utc.tm_year + 1900) % 10000;
+        char* out = Format::write_2digits(text, year / 100);
+        out = Format::write_2digits(out, year % 100);
+        *out++ = '-';
+        out = Format::write_2digits(out, static_cast<unsigned>(utc.tm_mon + 1));
+        *out++ = '-';
+        out = Format::write_2digits(out, static_cast<unsigned>(utc.tm_mday));
+        *out++ = 'T';
+        out = Format::write_2digits(out, static_cast<unsigned>(utc.tm_hour));
+        *out++ = ':';
+        out = Format::write_2digits(out, static_cast<unsigned>(utc.tm_min));
+        *out++ = ':';
+        out = Format::write_2digits(out, static_cast<unsigned>(utc.tm_sec));
+        *out++ = '.';
+        out = Format::write_2digits(out, fraction / 10000);
+        out = Format::write_2digits(out, fraction / 100 % 100);
+        out = Format::write_2digits(out, fraction % 100);
+        *out++ = 'Z';
+        mBuffer.append(text, static_cast<size_t>(out - text));
+    }
+
+    /// Native journald datagram: one KEY=VALUE line per field
+    void append_journald(Level level, uint32_t threadId, const SourceSite* site, const std::string& msg, bool sanitize)
+    {
+        mBuffer += "PRIORITY=";
+        Format::append_uint(mBuffer, static_cast<uint64_t>(severity(level)));
+        mBuffer += "\nSYSLOG_FACILITY=";
+        Format::append_uint(mBuffer, static_cast<uint64_t>(mFacility));
+        mBuffer += "\nSYSLOG_IDENTIFIER=";
+        mBuffer += mIdentifier;
+        mBuffer += "\nSYSLOG_PID=";
+        Format::append_uint(mBuffer, mPid);
+        mBuffer += "\nKL_THREAD=";
+        Format::append_uint(mBuffer, threadId);
+        mBuffer += '\n';
+        if (site != nullptr) {
+            mBuffer += "CODE_FILE=";
+            mBuffer += site->file;
+            mBuffer += "\nCODE_LINE=";
+            Format::append_int(mBuffer, site->line);
+            mBuffer += "\nCODE_FUNC=";
+            mBuffer += site->function;
+            mBuffer += '\n';
+        }
+
+        // Binary form: "MESSAGE\n", 64-bit little-endian length, the bytes, "\n". Works for any
+        // text, so it is used whenever the message is not a single line.
+        const size_t start = mBuffer.size();
+        mBuffer += "MESSAGE\n";
+        const size_t lengthAt = mBuffer.size();
+        mBuffer.append(sizeof(uint64_t), '\0');
+        const size_t textAt = mBuffer.size();
+        append_message(msg, sanitize);
+        const uint64_t length = mBuffer.size() - textAt;
+
+        if (std::string_view(mBuffer.data() + textAt, length).find('\n') == std::string_view::npos) {
+            // Single line: rewrite as MESSAGE=<text>
+            mBuffer.replace(start, textAt - start, "MESSAGE=");
+        }
+        else {
+            unsigned char bytes[sizeof(uint64_t)];
+            for (size_t i = 0; i < sizeof(bytes); ++i) {
+                bytes[i] = static_cast<unsigned char>(length >> (8 * i));
+            }
+            std::memcpy(&mBuffer[lengthAt], bytes, sizeof(bytes));
+        }
+        mBuffer += '\n';
+    }
+
+    void append_message(const std::string& msg, bool sanitize)
+    {
+        if (sanitize) {
+            Sanitizer::append_sanitized(mBuffer, msg);
+        }
+        else {
+            mBuffer += msg;
+        }
+    }
+
+    /// RFC 5424 header field: printable ASCII without spaces, at most maxLength characters
+    static std::string printable(std::string name, size_t maxLength)
+    {
+        if (name.size() > maxLength) {
+            name.resize(maxLength);
+        }
+        for (char& c : name) {
+            if (c <= ' ' || c > '~') {
+                c = '_';
+            }
+        }
+        return name;
+    }
+
+    /// APP-NAME (48 characters at most): the requested identifier or the program name
+    static std::string make_identifier(const std::string& requested)
+    {
+        std::string name = requested;
+        if (name.empty()) {
+            #if defined(__GLIBC__) && defined(_GNU_SOURCE)
+                name = program_invocation_short_name;
+            #elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+                name = getprogname();
+            #endif
+        }
+        return printable(name.empty() ? std::string("kLogger") : name, 48);
+    }
+
+    /// HOSTNAME (255 characters at most), "-" when unknown
+    static std::string make_hostname()
+    {
+        char name[256] = {};
+        if (::gethostname(name, sizeof(name) - 1) != 0 || name[0] == '\0') {
+            return "-";
+        }
+        return printable(name, 255);
+    }
+
+    int mFd{-1};
+    bool mConnected{false};
+    sockaddr_un mAddress{};
+    std::chrono::steady_clock::time_point mNextConnect{};
+
+    SyslogProtocol mProtocol{SyslogProtocol::Off};
+    int mFacility{1};
+    uint32_t mPid{0};
+    std::string mIdentifier;
+    std::string mHostname;
+
+    // Pending batch: datagram i is mBuffer[mEnds[i - 1], mEnds[i])
+    std::string mBuffer;
+    std::vector<size_t> mEnds;
+    #if defined(__linux__)
+        std::array<iovec, kMaxBatch> mIov{};
+        std::array<mmsghdr, kMaxBatch> mMessages{};
+    #endif
+
+    std::atomic<uint64_t> mSent{0};
+    std::atomic<uint64_t> mDropped{0};
+};
+
+} // namespace KL
+
+#endif // !_WIN32
+
+#endif //! SYSLOGSINK_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef THREADINFO_H
+#define THREADINFO_H
+
+#include <string>           // For std::string
+#include <vector>           // For std::vector
+#include <mutex>            // For std::mutex
+#include <atomic>           // For std::atomic
+#include <cstdint>          // For uint32_t, uint64_t
+
+namespace KL {
+
+/**
+ * @brief Cheap per-thread identity for log entries.
+ *
+ * Each thread gets a small sequential id (1, 2, 3, ...) the first time it logs. The id is
+ * cached in a constant-initialized thread_local, so after the first call reading it is a
+ * single TLS load and a predictable branch - no std::this_thread::get_id() hashing.
+ *
+ * Names are optional and registered once per thread with set_thread_name(). They are kept
+ * in a small id-indexed table that the worker copies only when it changes.
+ */
+namespace ThreadInfo {
+
+    namespace detail {
+        inline thread_local uint32_t tThreadId = 0; // 0 = not assigned yet
+
+        inline std::atomic<uint32_t>& id_counter()
+        {
+            static std::atomic<uint32_t> counter{0};
+            return counter;
+        }
+
+        /// Slow path: runs once per thread
+        inline uint32_t assign_id() noexcept
+        {
+            tThreadId = id_counter().fetch_add(1, std::memory_order_relaxed) + 1;
+            return tThreadId;
+        }
+
+        /// id -> name table shared by all loggers
+        struct NameTable {
+            std::mutex mutex;
+            std::vector<std::string> names;         // Index = thread id
+            std::atomic<uint64_t> generation{0};    // Bumped on every change
+        };
+
+        /// Intentionally never destroyed: loggers may still format lines during static destruction
+        inline NameTable& name_table()
+        {
+            static NameTable* table = new NameTable();
+            return *table;
+        }
+    }
+
+    /// Returns the calling thread's logger id (never 0)
+    inline uint32_t current_id() noexcept
+    {
+        const uint32_t id = detail::tThreadId;
+        return (id != 0) ? id : detail::assign_id();
+    }
+
+    /// Current version of the name table; changes whenever a name is set
+    inline uint64_t names_generation() noexcept
+    {
+        return detail::name_table().generation.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Copies the name table into out (worker side).
+     * @return The generation the copy corresponds to.
+     */
+    inline uint64_t copy_names(std::vector<std::string>& out)
+    {
+        auto& table = detail::name_table();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        out = table.names;
+        return table.generation.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Gives the calling thread a human-readable name shown next to its id in log lines.
+ *
+ * Meant to be called once, when the thread starts. Calling it again renames the thread.
+ *
+ * @param name Thread name (e.g. "net-rx")
+ */
+inline void set_thread_name(const std::string& name)
+{
+    const uint32_t id = ThreadInfo::current_id();
+
+    auto& table = ThreadInfo::detail::name_table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    if (table.names.size() <= id) {
+        table.names.resize(id + 1);
+    }
+    table.names[id] = name;
+    table.generation.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace KL
+
+#endif //! THREADINFO_H
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include <string>           // For std::string
+#include <vector>           // For std::vector
+#include <cerrno>           // For errno
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>    // SetThreadAffinityMask, SetThreadPriority
+#else
+    #include <pthread.h>    // pthread_setname_np, pthread_setschedparam, pthread_setaffinity_np
+    #include <sched.h>      // SCHED_*, cpu_set_t
+    #include <sys/resource.h> // setpriority
+    #if defined(__linux__)
+        #include <sys/syscall.h>  // SYS_gettid
+        #include <unistd.h>       // syscall
+    #endif
+#endif
+
+#include "Config.h"
+
+namespace KL {
+
+/**
+ * @brief Name, CPU affinity and scheduling class of the calling thread.
+ *
+ * Used by the worker thread on itself right after it starts (see Config::workerCpus). Every
+ * function returns false when the platform does not support the request or the OS refuses it
+ * (errno is left as set by the failing call).
+ */
+namespace ThreadPlacement {
+
+    /// Names the calling thread (shown by top -H, perf, gdb). Linux truncates to 15 characters.
+    inline bool set_name(const std::string& name)
+    {
+        #if defined(__linux__)
+            const std::string truncated = name.substr(0, 15);
+            return pthread_setname_np(pthread_self(), truncated.c_str()) == 0;
+        #elif defined(__APPLE__)
+            return pthread_setname_np(name.c_str()) == 0;
+        #else
+            (void)name;
+            return false;
+        #endif
+    }
+
+    /// Restricts the calling thread to the given CPU numbers
+    inline bool pin(const std::vector<int>& cpus)
+    {
+        if (cpus.empty()) {
+            return true;
+        }
+
+        #if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus) {
+                if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                    errno = EINVAL;
+                    return false;
+                }
+                CPU_SET(cpu, &set);
+            }
+            const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (rc != 0) {
+                errno = rc;
+            }
+            return rc == 0;
+        #elif defined(_WIN32)
+            DWORD_PTR mask = 0;
+            for (int cpu : cpus) {
+                if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+                    errno = EINVAL;
+                    return false;
+                }
+                mask |= DWORD_PTR{1} << cpu;
+            }
+            return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+        #else
+            errno = ENOTSUP;    // macOS has no hard affinity
+            return false;
+        #endif
+    }
+
+    /**
+     * @brief Sets the calling thread's scheduling class.
+     * @param policy   Scheduling class (Inherit does nothing)
+     * @param priority Real-time priority for Fifo/RoundRobin, nice value otherwise
+     */
+    inline bool set_scheduling(ThreadPolicy policy, int priority)
+    {
+        if (policy == ThreadPolicy::Inherit) {
+            return true;
+        }
+
+        #if defined(_WIN32)
+            // Closest Windows equivalents: real-time classes map to TIME_CRITICAL, Idle to IDLE
+            int level = THREAD_PRIORITY_NORMAL;
+            switch (policy) {
+                case ThreadPolicy::Fifo:
+                case ThreadPolicy::RoundRobin: level = THREAD_PRIORITY_TIME_CRITICAL; break;
+                case ThreadPolicy::Idle:       level = THREAD_PRIORITY_IDLE; break;
+                default:                       level = (priority < 0) ? THREAD_PRIORITY_ABOVE_NORMAL
+                                                      : (priority > 0) ? THREAD_PRIORITY_BELOW_NORMAL
+                                                      : THREAD_PRIORITY_NORMAL; break;
+            }
+            return SetThreadPriority(GetCurrentThread(), level) != 0;
+        #else
+            int native = SCHED_OTHER;
+            switch (policy) {
+                case ThreadPolicy::Fifo:       native = SCHED_FIFO; break;
+                case ThreadPolicy::RoundRobin: native = SCHED_RR; break;
+                #if defined(__linux__)
+                    case ThreadPolicy::Batch:  native = SCHED_BATCH; break;
+                    case ThreadPolicy::Idle:   native = SCHED_IDLE; break;
+                #else
+                    case ThreadPolicy::Batch:
+                    case ThreadPolicy::Idle:   errno = ENOTSUP; return false;
+                #endif
+                default:                       native = SCHED_OTHER; break;
+            }
+
+            const bool realTime = (native == SCHED_FIFO || native == SCHED_RR);
+            sched_param param{};
+            param.sched_priority = realTime ? priority : 0;
+            const int rc = pthread_setschedparam(pthread_self(), native, &param);
+            if (rc != 0) {
+                errno = rc;
+                return false;
+            }
+
+            #if defined(__linux__)
+                // On Linux, nice applies per thread (addressed by its tid)
+                if (!realTime && priority != 0) {
+                    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+                    return setpriority(PRIO_PROCESS, tid, priority) == 0;
+                }
+            #endif
+            return true;
+        #endif
+    }
+}
+
+} // namespace KL
+
+#endif //! THREADPLACEMENT_H
\ No newline at end of file
@@ -0,0 +1,307 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>               // For std::atomic
+#include <chrono>               // For the timer tick
+#include <condition_variable>   // For std::condition_variable
+#include <cstdint>              // For uint8_t
+#include <deque>                // For std::deque
+#include <memory>               // For std::unique_ptr
+#include <mutex>                // For std::mutex
+#include <string>               // For std::string
+#include <thread>               // For std::thread
+#include <vector>               // For std::vector
+#include <algorithm>            // For std::remove
+
+#include "CrashHandler.h"
+#include "ThreadPlacement.h"
+
+namespace KL {
+
+class WorkerPool;
+
+/**
+ * @brief Something a WorkerPool drains: in practice a Logger attached through Config::workerPool.
+ *
+ * The pool owns a client while it is queued or being drained, tracked by a small state word:
+ * producers only touch the pool when they move the client from idle to active, and an active
+ * client that receives more work is just marked pending (see WorkerPool::notify()).
+ */
+class PoolClient {
+public:
+    /**
+     * @brief Drains at most budget queued entries as one batch and runs due timer work.
+     * @return true if entries are still queued.
+     */
+    virtual bool drain_some(size_t budget) = 0;
+
+protected:
+    ~PoolClient() = default;
+
+private:
+    friend class WorkerPool;
+
+    static constexpr uint8_t kActive  = 1;   // Queued on a lane or being drained
+    static constexpr uint8_t kPending = 2;   // More work arrived while active
+
+    std::atomic<uint8_t> mPoolState{0};
+    size_t mPoolLane{0};        // Lane producers schedule onto
+};
+
+/**
+ * @brief N worker threads shared by any number of loggers.
+ *
+ * Every thread has a lane (FIFO of ready clients). A client is scheduled onto its home lane,
+ * drained for at most `quantum` entries and, if still busy, put back at the end of the lane
+ * of the thread that drained it, so one hot logger cannot starve the others. A thread whose
+ * lane is empty steals the oldest ready client from another lane before it sleeps.
+ *
+ * @code
+ * auto pool = std::make_shared<KL::WorkerPool>(2);
+ * KL::Config cfg;
+ * cfg.workerPool = pool;
+ * cfg.filePrefix = "net";
+ * KL::Logger net(cfg);
+ * @endcode
+ *
+ * Loggers keep the pool alive (shared_ptr); the threads stop when the last one is gone.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param threads    Worker threads (at least one)
+     * @param quantum    Entries one logger may drain before the thread moves on to the next
+     * @param threadName Name given to every pool thread (see ThreadPlacement::set_name())
+     */
+    explicit WorkerPool(size_t threads = 1, size_t quantum = 256, const std::string& threadName = "kl-pool")
+        : mQuantum(quantum == 0 ? 1 : quantum)
+    {
+        const size_t count = (threads == 0) ? 1 : threads;
+        for (size_t i = 0; i < count; ++i) {
+            mLanes.push_back(std::make_unique<Lane>());
+        }
+        for (size_t i = 0; i < count; ++i) {
+            mThreads.emplace_back([this, i, threadName]() {
+                if (!threadName.empty()) {
+                    ThreadPlacement::set_name(threadName);
+                }
+                Crash::install_alt_stack();
+                run(i);
+            });
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mStopping = true;
+        }
+        mCV.notify_all();
+
+        for (auto& thread : mThreads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// Number of worker threads
+    size_t thread_count() const noexcept
+    {
+        return mThreads.size();
+    }
+
+    /**
+     * @brief Starts serving client. Home lanes are handed out round-robin.
+     * @param timers The client has timer work and must be drained periodically even when idle
+     */
+    void attach(PoolClient& client, bool timers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            client.mPoolLane = mNextLane++ % mLanes.size();
+            if (timers) {
+                mTimerClients.push_back(&client);
+                mTimerClientCount.store(mTimerClients.size());
+            }
+        }
+        if (timers) {
+            {
+                std::lock_guard<std::mutex> lock(mSleepMutex);
+            }
+            mCV.notify_all();     // Sleepers start waking up for the tick
+        }
+    }
+
+    /**
+     * @brief Stops serving client and waits until no thread holds it.
+     *
+     * The client stays marked active for good afterwards, so notify() never queues it again;
+     * the caller drains whatever is left itself.
+     */
+    void detach(PoolClient& client)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTimerClients.erase(std::remove(mTimerClients.begin(), mTimerClients.end(), &client), mTimerClients.end());
+            mTimerClientCount.store(mTimerClients.size());
+        }
+
+        uint8_t expected = 0;
+        while (!client.mPoolState.compare_exchange_weak(expected, PoolClient::kActive)) {
+            expected = 0;
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Producer side: makes sure client will be drained after the entry just queued.
+     *
+     * Costs a fence and a load while the client is already pending; the pool is only
+     * touched on the idle -> active transition. The fence pairs with the one in drain():
+     * either the producer sees the pending flag cleared, or the drain sees the entry.
+     */
+    void notify(PoolClient& client)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (client.mPoolState.load(std::memory_order_relaxed) & PoolClient::kPending) {
+            return;
+        }
+        const uint8_t previous = client.mPoolState.fetch_or(PoolClient::kActive | PoolClient::kPending, std::memory_order_acq_rel);
+        if ((previous & PoolClient::kActive) == 0) {
+            push(client.mPoolLane, client);
+        }
+    }
+
+private:
+    struct Lane {
+        std::mutex mutex;
+        std::deque<PoolClient*> ready;
+    };
+
+    static constexpr std::chrono::milliseconds kTick{10};   // Timer resolution for idle clients
+
+    /// Queues client at the end of a lane and wakes a sleeping thread, if any
+    void push(size_t lane, PoolClient& client)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mLanes[lane]->mutex);
+            mLanes[lane]->ready.push_back(&client);
+        }
+        mQueued.fetch_add(1, std::memory_order_seq_cst);
+        if (mSleepers.load(std::memory_order_seq_cst) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(mSleepMutex);
+            }
+            mCV.notify_one();
+        }
+    }
+
+    /// Own lane first, then the oldest ready client of any other lane
+    PoolClient* take(size_t self)
+    {
+        for (size_t n = 0; n < mLanes.size(); ++n) {
+            Lane& lane = *mLanes[(self + n) % mLanes.size()];
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            if (!lane.ready.empty()) {
+                PoolClient* client = lane.ready.front();
+                lane.ready.pop_front();
+                mQueued.fetch_sub(1, std::memory_order_relaxed);
+                return client;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Drains one quantum of client, then requeues it (still busy) or releases it (idle)
+    void drain(size_t self, PoolClient& client)
+    {
+        client.mPoolState.fetch_and(static_cast<uint8_t>(~PoolClient::kPending), std::memory_order_seq_cst);
+
+        if (!client.drain_some(mQuantum)) {
+            uint8_t expected = PoolClient::kActive;
+            if (client.mPoolState.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+                return;     // Released: client may be detached from here on, do not touch it
+            }
+        }
+        push(self, client);
+    }
+
+    /// Schedules every client with timer work, at most once per kTick across all threads
+    void tick()
+    {
+        if (mTimerClientCount.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t due = mNextTick.load(std::memory_order_relaxed);
+        if (now < due || !mNextTick.compare_exchange_strong(due, now + std::chrono::nanoseconds(kTick).count())) {
+            return;
+        }
+
+        // Under mMutex, so detach() cannot finish while one of its clients is being scheduled
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (PoolClient* client : mTimerClients) {
+            notify(*client);
+        }
+    }
+
+    /// Sleeps until a client is queued, the next tick is due or the pool stops
+    bool sleep()
+    {
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mSleepers.fetch_add(1, std::memory_order_seq_cst);
+
+        const auto ready = [this] { return mQueued.load(std::memory_order_seq_cst) > 0 || mStopping; };
+        if (mTimerClientCount.load(std::memory_order_relaxed) == 0) {
+            mCV.wait(lock, ready);
+        }
+        else {
+            mCV.wait_for(lock, kTick, ready);
+        }
+
+        mSleepers.fetch_sub(1, std::memory_order_relaxed);
+        return !mStopping;
+    }
+
+    void run(size_t self)
+    {
+        while (true) {
+            if (PoolClient* client = take(self)) {
+                drain(self, *client);
+            }
+            else if (!sleep()) {
+                return;
+            }
+            tick();
+        }
+    }
+
+    size_t mQuantum;
+    std::vector<std::unique_ptr<Lane>> mLanes;
+    std::vector<std::thread> mThreads;
+
+    std::atomic<size_t> mQueued{0};     // Clients waiting on any lane
+    std::atomic<size_t> mSleepers{0};
+
+    // Idle threads sleep on mCV
+    std::mutex mSleepMutex;
+    std::condition_variable mCV;
+    bool mStopping{false};
+
+    // Client bookkeeping, guarded by mMutex
+    std::mutex mMutex;
+    size_t mNextLane{0};
+    std::vector<PoolClient*> mTimerClients;
+    std::atomic<size_t> mTimerClientCount{0};
+    std::atomic<int64_t> mNextTick{0};      // steady_clock nanoseconds
+};
+
+} // namespace KL
+
+#endif //! WORKERPOOL_H
\ No newline at end of file
@@ -0,0 +1,215 @@
+/**
+ * @file kl_collector.cpp
+ * @brief Drains a kLogger shared-memory ring (Config::sharedMemoryName) to rotating log files.
+ *
+ * Usage: kl-collector <segment-name> [--dir DIR] [--prefix P] [--max-lines N] [--poll-ms N] [--wait] [--keep]
+ *
+ *   --dir DIR       Output directory (default: current directory)
+ *   --prefix P      File name prefix, as Config::filePrefix (default: klog)
+ *   --max-lines N   Lines per file before rotation (default: 100000)
+ *   --poll-ms N     Sleep between polls when the ring is empty (default: 10)
+ *   --wait          Retry until the segment exists instead of failing
+ *   --keep          Do not unlink the segment on exit
+ *
+ * Runs until the producer closes the ring or dies, then drains whatever is left (skipping a
+ * record its producer never finished), unlinks the segment (unless a restarted producer has
+ * already replaced it under the same name) and exits. Because the collector is
+ * a separate process, records already copied into the ring reach disk even if the producer is
+ * SIGKILLed.
+ */
+
+#include <KL/ShmRing.h>
+#include <KL/IO.h>
+#include <KL/Sanitizer.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace {
+
+volatile std::sig_atomic_t gStop = 0;
+
+void on_signal(int) { gStop = 1; }
+
+struct Options {
+    std::string name;
+    std::filesystem::path directory = std::filesystem::current_path();
+    std::string prefix = "klog";
+    size_t maxLines = 100000;
+    int pollMs = 10;
+    bool wait = false;
+    bool keep = false;
+};
+
+/// Rotating output file; same naming scheme as the in-process file sink
+class OutputFile {
+public:
+    OutputFile(std::filesystem::path directory, std::string prefix, size_t maxLines)
+        : mDirectory(std::move(directory)), mPrefix(std::move(prefix)), mMaxLines(maxLines) {}
+
+    ~OutputFile() { close(); }
+
+    void append(const std::string& line)
+    {
+        if (mFd < 0 || mLines >= mMaxLines) {
+            open_next();
+        }
+        mBuffer += line;
+        mBuffer += '\n';
+        ++mLines;
+    }
+
+    void flush()
+    {
+        if (mFd >= 0 && !mBuffer.empty() && !KL::IO::write_all(mFd, mBuffer.data(), mBuffer.size())) {
+            std::fprintf(stderr, "kl-collector: write failed: %s\n", std::strerror(errno));
+        }
+        mBuffer.clear();
+    }
+
+    void close()
+    {
+        flush();
+        if (mFd >= 0) {
+            KL::IO::sync_data(mFd);
+            KL::IO::close(mFd);
+            mFd = -1;
+        }
+    }
+
+private:
+    void open_next()
+    {
+        close();
+
+        const auto now = std::chrono::system_clock::now();
+        const auto time_t_val = std::chrono::system_clock::to_time_t(now);
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+        std::tm tm_val{};
+        localtime_r(&time_t_val, &tm_val);
+
+        char stamp[64];
+        std::snprintf(stamp, sizeof(stamp), "_%02d-%02d-%04d-%02d-%02d-%02d-%03d.txt",
+                      tm_val.tm_mday, tm_val.tm_mon + 1, tm_val.tm_year + 1900,
+                      tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec, static_cast<int>(ms.count()));
+
+        const auto path = mDirectory / (mPrefix + stamp);
+        mFd = KL::IO::open_append(path);
+        if (mFd < 0) {
+            std::fprintf(stderr, "kl-collector: cannot open %s: %s\n", path.c_str(), std::strerror(errno));
+        }
+        mLines = 0;
+    }
+
+    std::filesystem::path mDirectory;
+    std::string mPrefix;
+    size_t mMaxLines;
+    size_t mLines{0};
+    int mFd{-1};
+    std::string mBuffer;
+};
+
+/// [DD-MM-YYYY HH:MM:SS.mmm][LEVEL][T<id>][msg]
+void format_record(const KL::ShmRing::Record& record, std::string& line)
+{
+    const auto millis = record.timestampNanos / 1000000;
+    const std::time_t seconds = static_cast<std::time_t>(millis / 1000);
+    std::tm tm_val{};
+    localtime_r(&seconds, &tm_val);
+
+    char prefix[96];
+    const int length = std::snprintf(prefix, sizeof(prefix), "[%02d-%02d-%04d %02d:%02d:%02d.%03d][%s][T%u][",
+                                     tm_val.tm_mday, tm_val.tm_mon + 1, tm_val.tm_year + 1900,
+                                     tm_val.tm_hour, tm_val.tm_min, tm_val.tm_sec,
+                                     static_cast<int>(millis % 1000), KL::level_name(record.level),
+                                     record.threadId);
+    line.assign(prefix, static_cast<size_t>(length));
+    KL::Sanitizer::append_sanitized(line, record.message, record.messageLength);
+    line += ']';
+}
+
+bool parse(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--dir" && hasValue)            { options.directory = argv[++i]; }
+        else if (arg == "--prefix" && hasValue)    { options.prefix = argv[++i]; }
+        else if (arg == "--max-lines" && hasValue) { options.maxLines = std::strtoul(argv[++i], nullptr, 10); }
+        else if (arg == "--poll-ms" && hasValue)   { options.pollMs = std::atoi(argv[++i]); }
+        else if (arg == "--wait")                  { options.wait = true; }
+        else if (arg == "--keep")                  { options.keep = true; }
+        else if (!arg.empty() && arg[0] != '-' && options.name.empty()) { options.name = arg; }
+        else { return false; }
+    }
+    return !options.name.empty() && !options.prefix.empty() && options.maxLines > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s <segment-name> [--dir DIR] [--prefix P] [--max-lines N] [--poll-ms N] [--wait] [--keep]\n", argv[0]);
+        return 2;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    KL::ShmRing ring;
+    while (!ring.attach(options.name)) {
+        if (!options.wait || gStop) {
+            std::fprintf(stderr, "kl-collector: cannot attach to %s: %s\n", options.name.c_str(), std::strerror(errno));
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.pollMs));
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.directory, ec);
+
+    OutputFile output(options.directory, options.prefix, options.maxLines);
+    std::string line;
+    line.reserve(512);
+    const auto write_record = [&](const KL::ShmRing::Record& record) {
+        format_record(record, line);
+        output.append(line);
+    };
+
+    uint64_t total = 0;
+    while (!gStop) {
+        const bool producerGone = ring.producer_gone();
+        const size_t drained = ring.drain(write_record, 4096);
+        total += drained;
+        output.flush();
+
+        if (drained == 0) {
+            if (producerGone) {
+                // Final pass: nothing more will be committed, so torn records can be skipped
+                total += ring.drain(write_record, static_cast<size_t>(-1), true);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.pollMs));
+        }
+    }
+
+    output.close();
+
+    const uint64_t dropped = ring.header()->dropped.load();
+    std::fprintf(stderr, "kl-collector: %llu records written, %llu dropped by the producer\n",
+                 static_cast<unsigned long long>(total), static_cast<unsigned long long>(dropped));
+
+    if (!options.keep && !gStop && !ring.unlink_if_same()) {
+        std::fprintf(stderr, "kl-collector: %s no longer names the drained segment, left in place\n", options.name.c_str());
+    }
+    return 0;
+}